@@ -1,67 +1,211 @@
 #include <aoc2020/aoc2020.hpp>
+#include <aoc2020/registry.hpp>
+#include <aoc2020/thread_pool.hpp>
 
-#include <fmt/core.h>
 #include <range/v3/all.hpp>
 
-#include <array>
-#include <fstream>
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <future>
+#include <mutex>
+#include <optional>
+#include <span>
+#include <stdexcept>
+#include <unordered_set>
+#include <vector>
 
 namespace rs = ranges;
 namespace rv = ranges::views;
 
-auto contains_last_element(const std::vector<int>& input)
+namespace {
+
+// Pair searches against a non-negative target up to this size mark seen values in a bitmap,
+// anything else goes through a hash set.
+constexpr int64_t max_bitmap_target = int64_t{1} << 24;
+
+// Triple searches over at least this many entries are spread across threads.
+constexpr std::size_t parallel_triple_threshold = std::size_t{1} << 14;
+
+// Two entries at distinct positions summing to target, in a single pass over the input.
+std::optional<std::vector<int>> find_pair(std::span<const int> input, int64_t target)
 {
-    return [&input](const auto& p) { return rs::contains(input, p.back()); };
+    auto non_negative = [](int v) { return v >= 0; };
+
+    if (target >= 0 && target <= max_bitmap_target && rs::all_of(input, non_negative)) {
+        std::vector<bool> seen(static_cast<std::size_t>(target) + 1);
+
+        for (int v : input) {
+            if (v > target) continue;
+
+            auto complement = static_cast<int>(target - v);
+            if (seen[static_cast<std::size_t>(complement)]) return std::vector{complement, v};
+
+            seen[static_cast<std::size_t>(v)] = true;
+        }
+
+        return std::nullopt;
+    }
+
+    std::unordered_set<int64_t> seen;
+    seen.reserve(input.size());
+
+    for (int v : input) {
+        if (seen.contains(target - v)) return std::vector{static_cast<int>(target - v), v};
+        seen.insert(v);
+    }
+
+    return std::nullopt;
 }
 
-auto accumulate_multiply()
+// k entries of sorted summing to target. Each level fixes its smallest entry and the last two are
+// found with converging pointers, so triples take O(n^2).
+bool find_sorted(std::span<const int> sorted, std::size_t k, int64_t target, std::vector<int>& picked)
 {
-    return [](auto&& p) { return rs::accumulate(p, 1, std::multiplies<>()); };
+    if (sorted.size() < k) return false;
+
+    if (k == 2) {
+        for (std::size_t lo = 0, hi = sorted.size() - 1; lo < hi;) {
+            auto sum = int64_t{sorted[lo]} + sorted[hi];
+
+            if (sum == target) {
+                picked.insert(picked.end(), {sorted[lo], sorted[hi]});
+                return true;
+            }
+
+            if (sum < target) ++lo;
+            else
+                --hi;
+        }
+
+        return false;
+    }
+
+    for (std::size_t i = 0; i + k <= sorted.size(); ++i) {
+        // The k smallest entries starting at i only grow with i.
+        if (rs::accumulate(sorted.subspan(i, k), int64_t{0}) > target) break;
+        if (i > 0 && sorted[i] == sorted[i - 1]) continue;
+
+        picked.push_back(sorted[i]);
+        if (find_sorted(sorted.subspan(i + 1), k - 1, target - sorted[i], picked)) return true;
+        picked.pop_back();
+    }
+
+    return false;
 }
 
-int part1(const std::vector<int>& input)
+// Triple search over sorted with the outer index handed out to threads in chunks, each running
+// the two-pointer scan over the shared array. best is the smallest outer index known to start a
+// triple; workers stop once they pass it, so the answer matches the single-threaded search. One
+// search runs on every worker of pool.
+std::optional<std::vector<int>>
+find_triple_parallel(std::span<const int> sorted, int64_t target, aoc::thread_pool& pool)
 {
-    // clang-format off
-    auto result = input 
-        | rv::transform([](auto i) { return std::array{i, 2020 - i}; })
-        | rv::filter(contains_last_element(input))
-        | rv::transform(accumulate_multiply());
-    // clang-format on
+    constexpr std::size_t chunk = 64;
+
+    if (sorted.size() < 3) return std::nullopt;
+
+    std::atomic<std::size_t> next{0};
+    std::atomic<std::size_t> best{sorted.size()};
+    std::mutex               mutex;
+    std::vector<int>         result;
+
+    auto search = [&] {
+        std::vector<int> picked;
+
+        for (auto first = next.fetch_add(chunk); first < best.load(); first = next.fetch_add(chunk)) {
+            auto last = std::min(first + chunk, sorted.size() - 2);
+
+            for (auto i = first; i < last && i < best.load(); ++i) {
+                if (int64_t{sorted[i]} + sorted[i + 1] + sorted[i + 2] > target) return;
+                if (i > 0 && sorted[i] == sorted[i - 1]) continue;
 
-    return rs::front(result);
+                picked.assign(1, sorted[i]);
+                if (!find_sorted(sorted.subspan(i + 1), 2, target - sorted[i], picked)) continue;
+
+                std::lock_guard lock{mutex};
+                if (i < best.load()) {
+                    best.store(i);
+                    result = picked;
+                }
+                return;
+            }
+        }
+    };
+
+    std::vector<std::future<void>> workers;
+
+    for (std::size_t t = 0; t < pool.size(); ++t) {
+        workers.push_back(pool.submit(search));
+    }
+
+    for (auto& worker : workers) {
+        worker.get();
+    }
+
+    if (best.load() == sorted.size()) return std::nullopt;
+
+    return result;
 }
 
-int part2(const std::vector<int>& input)
+// k entries at distinct positions of input summing to target, or nullopt when there are none.
+// Pairs take O(n), larger k sort a copy and take O(n^(k-1)); large triple searches run in parallel.
+std::optional<std::vector<int>> find_k_sum(std::span<const int> input, std::size_t k, int64_t target)
 {
-    // clang-format off
-    auto result = rv::cartesian_product(input, input)
-        | rv::transform([](auto&& i) { 
-            auto [a, b] = i;
-            return std::array{a, b, 2020 - a - b}; })
-        | rv::filter(contains_last_element(input))
-        | rv::transform(accumulate_multiply());
-    // clang-format on
+    if (k == 0 || input.size() < k) return std::nullopt;
 
-    return rs::front(result);
-}
+    if (k == 1) {
+        if (rs::contains(input, target)) return std::vector{static_cast<int>(target)};
+        return std::nullopt;
+    }
+
+    if (k == 2) return find_pair(input, target);
+
+    auto sorted = input | rs::to<std::vector>;
+    rs::sort(sorted);
+
+    if (k == 3 && sorted.size() >= parallel_triple_threshold) {
+        return find_triple_parallel(sorted, target, aoc::shared_pool());
+    }
 
-#ifndef UNIT_TESTING
+    std::vector<int> picked;
+    if (find_sorted(sorted, k, target, picked)) return picked;
 
-int main()
+    return std::nullopt;
+}
+
+int64_t product_of_k_sum(const std::vector<int>& input, std::size_t k, int64_t target)
 {
-    fmt::print("Advent of Code 2020 - Day 01\n");
+    auto entries = find_k_sum(input, k, target);
 
-    auto input = aoc::read_int_per_line(std::ifstream{"days/day01/puzzle.in"});
+    if (!entries) throw std::runtime_error{fmt::format("No {} entries sum to {}", k, target)};
+
+    return rs::accumulate(*entries, int64_t{1}, std::multiplies<>());
+}
 
-    fmt::print("Part 1 Solution: {}\n", part1(input));
-    fmt::print("Part 2 Solution: {}\n", part2(input));
+int64_t part1(const std::vector<int>& input)
+{
+    return product_of_k_sum(input, 2, 2020);
+}
 
-    return 0;
+int64_t part2(const std::vector<int>& input)
+{
+    return product_of_k_sum(input, 3, 2020);
 }
 
-#else
+const aoc::day_registrar registrar{
+    1,
+    [](const auto& input_path) { return aoc::read_int_per_line(aoc::mapped_input{input_path}.view()); },
+    part1,
+    part2};
+
+} // namespace
+
+#ifdef UNIT_TESTING
 
 #define CATCH_CONFIG_MAIN
+#include <aoc2020/generators.hpp>
 #include <catch2/catch.hpp>
 #include <sstream>
 
@@ -83,6 +227,105 @@ TEST_CASE("Can solve day 2 problems")
     SECTION("Can solve part 1 example") { REQUIRE(514579 == part1(input)); }
 
     SECTION("Can solve part 2 example") { REQUIRE(241861950 == part2(input)); }
+
+    SECTION("Can find k entries summing to any target")
+    {
+        REQUIRE(std::vector{366, 675, 979} == find_k_sum(input, 3, 2020));
+        REQUIRE(std::vector{299, 366, 675, 1456} == find_k_sum(input, 4, 2796));
+        REQUIRE(std::vector{1721, 299} == find_k_sum(input, 2, 2020));
+        REQUIRE(std::vector{1456} == find_k_sum(input, 1, 1456));
+        REQUIRE_FALSE(find_k_sum(input, 2, 100).has_value());
+        REQUIRE_FALSE(find_k_sum(input, 7, 2020).has_value());
+    }
+
+    SECTION("Uses every entry at most once")
+    {
+        REQUIRE_FALSE(find_k_sum(std::vector{1010, 5}, 2, 2020).has_value());
+        REQUIRE(std::vector{1010, 1010} == find_k_sum(std::vector{1010, 5, 1010}, 2, 2020));
+        REQUIRE_FALSE(find_k_sum(std::vector{673, 1, 2}, 3, 2019).has_value());
+    }
+
+    SECTION("Parallel triple search matches the sequential one")
+    {
+        std::vector<int> ledger;
+        for (int i = 0; i < 5000; ++i) {
+            ledger.push_back(1011 + (i * 7919) % 5000);
+        }
+        ledger.insert(ledger.end(), {400, 700, 920, 300, 1720});
+
+        auto sorted = ledger;
+        std::sort(sorted.begin(), sorted.end());
+
+        for (std::size_t threads : {1, 2, 8}) {
+            aoc::thread_pool pool{threads};
+
+            REQUIRE(std::vector{300, 400, 1320} == find_triple_parallel(sorted, 2020, pool));
+            REQUIRE(find_k_sum(ledger, 3, 2020) == find_triple_parallel(sorted, 2020, pool));
+            REQUIRE_FALSE(find_triple_parallel(sorted, 50, pool).has_value());
+        }
+    }
+
+    SECTION("Finds the pair and triple planted in generated ledgers")
+    {
+        const auto* generator = aoc::find_generator(1);
+        REQUIRE(generator != nullptr);
+
+        for (uint64_t seed = 1; seed <= 10; ++seed) {
+            fmt::memory_buffer buffer;
+            generator->generate(buffer, 200, seed);
+
+            auto ledger = aoc::read_int_per_line(std::stringstream{fmt::to_string(buffer)});
+
+            std::vector<std::vector<int>> pairs;
+            std::vector<std::vector<int>> triples;
+
+            for (std::size_t i = 0; i < ledger.size(); ++i) {
+                for (std::size_t j = i + 1; j < ledger.size(); ++j) {
+                    if (ledger[i] + ledger[j] == 2020) pairs.push_back({ledger[i], ledger[j]});
+
+                    for (std::size_t k = j + 1; k < ledger.size(); ++k) {
+                        if (ledger[i] + ledger[j] + ledger[k] == 2020) {
+                            triples.push_back({ledger[i], ledger[j], ledger[k]});
+                        }
+                    }
+                }
+            }
+
+            REQUIRE(pairs.size() == 1);
+            REQUIRE(triples.size() == 1);
+
+            auto pair   = find_k_sum(ledger, 2, 2020).value();
+            auto triple = find_k_sum(ledger, 3, 2020).value();
+            std::sort(pair.begin(), pair.end());
+            std::sort(pairs[0].begin(), pairs[0].end());
+            std::sort(triples[0].begin(), triples[0].end());
+
+            REQUIRE(pairs[0] == pair);
+            REQUIRE(triples[0] == triple);
+        }
+    }
+
+    SECTION("Reads ledgers strictly")
+    {
+        using namespace std::string_view_literals;
+
+        REQUIRE(std::vector{1, -2, 3} == aoc::read_int_per_line(" 1\r\n-2\n\n+3"sv));
+        REQUIRE(std::vector{INT32_MIN} == aoc::read_int_per_line("-2147483648"sv));
+        REQUIRE(std::vector{INT64_MIN} == aoc::read_int64_per_line("-9223372036854775808"sv));
+
+        REQUIRE_THROWS_AS(aoc::read_int_per_line("12\nabc\n"sv), std::runtime_error);
+        REQUIRE_THROWS_AS(aoc::read_int_per_line("12x\n"sv), std::runtime_error);
+        REQUIRE_THROWS_AS(aoc::read_int_per_line("-\n"sv), std::runtime_error);
+        REQUIRE_THROWS_AS(aoc::read_int_per_line("2147483648\n"sv), std::runtime_error);
+        REQUIRE_THROWS_AS(aoc::read_int64_per_line("99999999999999999999"sv), std::runtime_error);
+    }
+
+    SECTION("Handles negative entries and large targets")
+    {
+        auto large = std::vector{-5, 7, 1000000005};
+        REQUIRE(std::vector{-5, 1000000005} == find_k_sum(large, 2, 1000000000));
+        REQUIRE(std::vector{-7, 2, 9} == find_k_sum(std::vector{9, -7, 2, 40}, 3, 4));
+    }
 }
 
 #endif
@@ -1,4 +1,5 @@
-#include <fmt/core.h>
+#include <aoc2020/aoc2020.hpp>
+#include <aoc2020/registry.hpp>
 
 #ifdef _MSC_VER
 #pragma warning(push)
@@ -9,80 +10,147 @@
 #pragma warning(pop)
 #endif
 
-#include <fstream>
-#include <sstream>
+#include <algorithm>
+#include <array>
+#include <charconv>
+#include <cstdint>
+#include <span>
+#include <stdexcept>
+#include <string_view>
+#include <system_error>
+#include <utility>
 
 namespace rs = ranges;
 namespace rv = ranges::views;
 
+namespace {
+
 struct corporate_policy {
     int  min_count;
     int  max_count;
     char target;
 };
 
-using password_vec = std::vector<std::pair<corporate_policy, std::string>>;
+// The password views the line it was parsed from.
+using password_entry = std::pair<corporate_policy, std::string_view>;
+
+// Number of lines valid under each policy.
+struct password_tally {
+    int64_t part1 = 0;
+    int64_t part2 = 0;
+};
 
-std::pair<corporate_policy, std::string> parse_password_rule_string(const std::string& str)
+password_entry parse_password_rule_string(std::string_view str)
 {
-    char             junk;
-    corporate_policy p;
-    std::string      s;
+    corporate_policy p{};
+
+    const char* last = str.data() + str.size();
+
+    auto [dash, min_error] = std::from_chars(str.data(), last, p.min_count);
+    if (min_error != std::errc{} || dash == last || *dash != '-') {
+        throw std::runtime_error{"Invalid input received"};
+    }
 
-    std::stringstream ss{str};
+    auto [space, max_error] = std::from_chars(dash + 1, last, p.max_count);
+    if (max_error != std::errc{} || last - space < 3 || space[0] != ' ' || space[2] != ':') {
+        throw std::runtime_error{"Invalid input received"};
+    }
+
+    p.target = space[1];
 
-    ss >> p.min_count >> junk >> p.max_count >> p.target >> junk >> s;
+    std::string_view password{space + 3, static_cast<std::size_t>(last - space - 3)};
+    password.remove_prefix(std::min(password.find_first_not_of(' '), password.size()));
 
-    return std::make_pair(p, s);
+    return std::make_pair(p, password);
 }
 
-bool is_valid_day2_part1_pw(const std::pair<corporate_policy, std::string>& pw)
+bool within_policy(const corporate_policy& p, std::size_t count)
 {
-    auto c = rs::count(pw.second, pw.first.target);
-    return (c >= pw.first.min_count && c <= pw.first.max_count);
+    auto c = static_cast<int64_t>(count);
+    return (c >= p.min_count && c <= p.max_count);
 }
 
-bool is_valid_day2_part2_pw(const std::pair<corporate_policy, std::string>& pw)
+bool is_valid_day2_part1_pw(const password_entry& pw)
 {
-    const auto& str    = pw.second;
-    int         pos1   = pw.first.min_count - 1;
-    int         pos2   = pw.first.max_count - 1;
-    char        target = pw.first.target;
-
-    return (str[pos1] == target && str[pos2] != target) || (str[pos1] != target && str[pos2] == target);
+    return within_policy(pw.first, aoc::count_byte(pw.second, pw.first.target));
 }
 
-int64_t part1(const password_vec& input)
+bool is_valid_day2_part2_pw(const password_entry& pw)
 {
-    return rs::distance(input | rv::filter(is_valid_day2_part1_pw));
+    auto at = [&pw](int position) {
+        auto index = static_cast<std::size_t>(position - 1);
+        return position > 0 && index < pw.second.size() && pw.second[index] == pw.first.target;
+    };
+
+    return at(pw.first.min_count) != at(pw.first.max_count);
 }
 
-int64_t part2(const password_vec& input)
+// Checks every line against both policies in a single pass over the buffer. Passwords are counted in
+// place, a batch of lines at a time, so that the short passwords of neighbouring lines share a
+// vector load and only the batch's policies are kept.
+password_tally tally_passwords(std::string_view buffer)
 {
-    return rs::distance(input | rv::filter(is_valid_day2_part2_pw));
-}
+    constexpr std::size_t batch_size = 64;
 
-#ifndef UNIT_TESTING
+    password_tally                          tally;
+    std::array<corporate_policy, batch_size> policies;
+    std::array<aoc::byte_run, batch_size>    runs;
+    std::array<std::size_t, batch_size>      counts;
+    std::size_t                             pending = 0;
 
-int main()
-{
-    fmt::print("Advent of Code 2020 - Day 02\n");
+    auto flush = [&] {
+        aoc::count_bytes(buffer, std::span{runs}.first(pending), counts);
 
-    std::ifstream ifs{"days/day02/puzzle.in"};
+        for (std::size_t i = 0; i < pending; ++i) {
+            tally.part1 += within_policy(policies[i], counts[i]);
+        }
 
-    auto input = rs::getlines(ifs) | rv::transform(parse_password_rule_string) | rs::to<std::vector>;
+        pending = 0;
+    };
 
-    fmt::print("Part 1 Solution: {}\n", part1(input));
-    fmt::print("Part 2 Solution: {}\n", part2(input));
+    for (auto line : aoc::lines(buffer)) {
+        if (line.empty()) continue;
 
-    return 0;
+        auto pw = parse_password_rule_string(line);
+
+        auto offset       = static_cast<std::size_t>(pw.second.data() - buffer.data());
+        policies[pending] = pw.first;
+        runs[pending]     = {offset, pw.second.size(), pw.first.target};
+
+        tally.part2 += is_valid_day2_part2_pw(pw);
+
+        if (++pending == batch_size) flush();
+    }
+
+    flush();
+
+    return tally;
 }
 
-#else
+int64_t part1(const password_tally& input)
+{
+    return input.part1;
+}
+
+int64_t part2(const password_tally& input)
+{
+    return input.part2;
+}
+
+const aoc::day_registrar registrar{
+    2,
+    [](const auto& input_path) { return tally_passwords(aoc::mapped_input{input_path}.view()); },
+    part1,
+    part2};
+
+} // namespace
+
+#ifdef UNIT_TESTING
 
 #define CATCH_CONFIG_MAIN
 #include <catch2/catch.hpp>
-#include <sstream>
+#include <string>
+#include <vector>
 
 TEST_CASE("Can parse string into rule password pair", "[day02]")
 {
@@ -127,19 +195,67 @@ TEST_CASE("Can validate part 2 passwords", "[day02]")
     REQUIRE_FALSE(is_valid_day2_part2_pw(parse_password_rule_string("2-9 c: ccccccccc")));
 }
 
-TEST_CASE("Can solve day 2 problems")
+TEST_CASE("Can count target bytes", "[day02]")
 {
-    std::stringstream ss;
+    std::string text;
+    for (int i = 0; i < 200; ++i) {
+        text += static_cast<char>('a' + (i * 7) % 5);
+    }
 
-    ss << R"(1-3 a: abcde
-1-3 b: cdefg
-2-9 c: ccccccccc)";
+    for (std::size_t offset : {0, 3, 31, 150}) {
+        for (std::size_t length : {0, 1, 15, 16, 17, 33, 40}) {
+            auto expected = static_cast<std::size_t>(rs::count(text.substr(offset, length), 'c'));
+
+            REQUIRE(expected == aoc::count_byte(text, offset, length, 'c'));
+            REQUIRE(expected == aoc::count_byte(std::string_view{text}.substr(offset, length), 'c'));
+        }
+    }
+
+    SECTION("Batches neighbouring runs")
+    {
+        std::vector<aoc::byte_run> runs;
+        for (std::size_t offset = 0; offset < text.size();) {
+            auto wanted = offset % 11 == 0 ? std::size_t{37} : offset % 9;
+            auto length = std::min(wanted, text.size() - offset);
+            runs.push_back({offset, length, static_cast<char>('a' + offset % 5)});
+            offset += length + offset % 3 + (length == 0);
+        }
+
+        std::vector<std::size_t> counts(runs.size());
+        aoc::count_bytes(text, runs, counts);
+
+        for (std::size_t i = 0; i < runs.size(); ++i) {
+            auto run = std::string_view{text}.substr(runs[i].offset, runs[i].length);
+            REQUIRE(static_cast<std::size_t>(rs::count(run, runs[i].c)) == counts[i]);
+        }
+    }
+}
 
-    auto input = rs::getlines(ss) | rv::transform(parse_password_rule_string) | rs::to<std::vector>;
+TEST_CASE("Rejects malformed policies", "[day02]")
+{
+    REQUIRE_THROWS(parse_password_rule_string("1-3 abcde"));
+    REQUIRE_THROWS(parse_password_rule_string("a-3 a: abcde"));
+    REQUIRE_THROWS(parse_password_rule_string("1 3 a: abcde"));
+    REQUIRE_FALSE(is_valid_day2_part2_pw(parse_password_rule_string("4-9 a: abc")));
+}
+
+TEST_CASE("Can solve day 2 problems")
+{
+    auto input = tally_passwords(R"(1-3 a: abcde
+1-3 b: cdefg
+2-9 c: ccccccccc)");
 
     SECTION("Can solve part 1 example") { REQUIRE(2 == part1(input)); }
 
     SECTION("Can solve part 2 example") { REQUIRE(1 == part2(input)); }
+
+    SECTION("Ignores CRLF line endings and blank lines")
+    {
+        auto crlf = tally_passwords("1-3 a: abcde\r\n1-3 b: cdefg\r\n\r\n2-9 c: ccccccccc\r\n");
+
+        REQUIRE(2 == part1(crlf));
+        REQUIRE(1 == part2(crlf));
+    }
 }
 
 #endif
@@ -1,71 +1,124 @@
+#include <aoc2020/aoc2020.hpp>
+#include <aoc2020/registry.hpp>
 
-#include <fmt/core.h>
 #include <range/v3/all.hpp>
 
-#include <fstream>
-#include <string>
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <stdexcept>
+#include <string_view>
+#include <vector>
 
 namespace rs = ranges;
 namespace rv = ranges::views;
 
-auto slope_type1_hits(const std::vector<std::string>& input, int slope)
-{
-    auto hit_test = [slope](auto&& p) {
-        auto&& [depth, line] = p;
-        return (line[(depth * slope) % line.length()] == '#') ? 1 : 0;
-    };
+namespace {
 
-    return rs::accumulate(rv::enumerate(input) | rv::transform(hit_test), 0);
-}
+struct slope {
+    std::size_t right;
+    std::size_t down;
+};
+
+constexpr std::array<slope, 5> puzzle_slopes{{{1, 1}, {3, 1}, {5, 1}, {7, 1}, {1, 2}}};
 
-auto slope_type2_hits(const std::vector<std::string>& input)
+// Sets bit c of bits for every tree in column c of line.
+void pack_row(std::string_view line, std::vector<uint64_t>& bits)
 {
-    auto hit_test = [](auto&& p) {
-        auto&& [depth, line] = p;
-        return (depth % 2 == 0 && line[(depth / 2) % line.length()] == '#') ? 1 : 0;
-    };
+    bits.assign((line.size() + 63) / 64, 0);
 
-    return rs::accumulate(rv::enumerate(input) | rv::transform(hit_test), 0);
+    for (std::size_t c = 0; c < line.size(); ++c) {
+        bits[c / 64] |= static_cast<uint64_t>(line[c] == '#') << (c % 64);
+    }
 }
 
-int part1(const std::vector<std::string>& input)
+// Trees hit on each slope in one pass over the rows of buffer. Only the current row is kept, packed
+// into a bitmap that every slope landing on it probes, so maps of any height can be streamed. Rows
+// no slope lands on are skipped without packing.
+std::vector<int64_t> count_trees(std::string_view buffer, std::span<const slope> slopes)
 {
-    return slope_type1_hits(input, 3);
-}
+    for (const auto& s : slopes) {
+        if (s.down == 0) throw std::invalid_argument{"Slopes must move down at least one row"};
+    }
 
-int part2(const std::vector<std::string>& input)
-{
-    return slope_type1_hits(input, 1) * slope_type1_hits(input, 3) * slope_type1_hits(input, 5)
-           * slope_type1_hits(input, 7) * slope_type2_hits(input);
-}
+    std::vector<int64_t>     hits(slopes.size());
+    std::vector<std::size_t> columns(slopes.size());
+    std::vector<std::size_t> steps(slopes.size());
+    std::vector<uint64_t>    bits;
 
-#ifndef UNIT_TESTING
+    std::size_t width = 0;
+    std::size_t row   = 0;
 
-int main()
-{
-    fmt::print("Advent of Code 2020 - Day 03\n");
+    for (auto line : aoc::lines(buffer)) {
+        if (line.empty()) continue;
+
+        if (width == 0) {
+            width = line.size();
+            for (std::size_t s = 0; s < slopes.size(); ++s) {
+                steps[s] = slopes[s].right % width;
+            }
+        }
+        else if (line.size() != width) {
+            throw std::runtime_error{"Invalid input received"};
+        }
+
+        auto lands = [row](const slope& s) { return row % s.down == 0; };
+
+        if (std::none_of(slopes.begin(), slopes.end(), lands)) {
+            ++row;
+            continue;
+        }
+
+        pack_row(line, bits);
+
+        for (std::size_t s = 0; s < slopes.size(); ++s) {
+            if (!lands(slopes[s])) continue;
 
-    std::ifstream ifs{"days/day03/puzzle.in"};
+            auto& column = columns[s];
 
-    auto input = rs::getlines(ifs) | rs::to<std::vector>;
+            hits[s] += static_cast<int64_t>((bits[column / 64] >> (column % 64)) & 1);
 
-    fmt::print("Part 1 Solution: {}\n", part1(input));
-    fmt::print("Part 2 Solution: {}\n", part2(input));
+            column += steps[s];
+            if (column >= width) column -= width;
+        }
 
-    return 0;
+        ++row;
+    }
+
+    return hits;
+}
+
+int64_t part1(const std::vector<int64_t>& hits)
+{
+    return hits[1];
+}
+
+int64_t part2(const std::vector<int64_t>& hits)
+{
+    return rs::accumulate(hits, int64_t{1}, std::multiplies<>());
 }
 
-#else
+const aoc::day_registrar registrar{
+    3,
+    [](const auto& input_path) {
+        return count_trees(aoc::mapped_input{input_path}.view(), puzzle_slopes);
+    },
+    part1,
+    part2};
+
+} // namespace
+
+#ifdef UNIT_TESTING
 
 #define CATCH_CONFIG_MAIN
 #include <catch2/catch.hpp>
-#include <sstream>
+#include <string>
 
 TEST_CASE("Can solve day 3 problems")
 {
-    std::stringstream ss;
-
-    ss << R"(..##.......
+    auto map = R"(..##.......
 #...#...#..
 .#....#..#.
 ..#.#...#.#
@@ -77,11 +130,37 @@ TEST_CASE("Can solve day 3 problems")
 #...##....#
 .#..#...#.#)";
 
-    auto input = rs::getlines(ss) | rs::to<std::vector>;
+    auto input = count_trees(map, puzzle_slopes);
 
     SECTION("Can solve part 1 example") { REQUIRE(7 == part1(input)); }
 
     SECTION("Can solve part 2 example") { REQUIRE(336 == part2(input)); }
+
+    SECTION("Can count any list of slopes")
+    {
+        constexpr std::array<slope, 4> slopes{{{3, 1}, {14, 1}, {0, 3}, {2, 5}}};
+
+        REQUIRE(std::vector<int64_t>{7, 7, 1, 2} == count_trees(map, slopes));
+        REQUIRE(std::vector<int64_t>{2, 2} == count_trees(map, std::vector<slope>{{1, 2}, {2, 5}}));
+    }
+
+    SECTION("Handles rows wider than one word and CRLF line endings")
+    {
+        std::string wide;
+        for (int row = 0; row < 4; ++row) {
+            auto line = std::string(260, '.');
+            line[static_cast<std::size_t>(row * 65)] = '#';
+            wide += line + "\r\n";
+        }
+
+        REQUIRE(std::vector<int64_t>{4, 1} == count_trees(wide, std::vector<slope>{{65, 1}, {1, 1}}));
+        REQUIRE_THROWS(count_trees("..#\n.#\n", puzzle_slopes));
+    }
+
+    SECTION("Rejects slopes that never move down")
+    {
+        REQUIRE_THROWS_AS(count_trees(map, std::vector<slope>{{3, 1}, {1, 0}}), std::invalid_argument);
+    }
 }
 
 #endif
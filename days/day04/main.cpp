@@ -1,144 +1,272 @@
-#include <fmt/core.h>
-#include <range/v3/all.hpp>
+#include <aoc2020/aoc2020.hpp>
+#include <aoc2020/registry.hpp>
+#include <aoc2020/thread_pool.hpp>
 
-#include <fstream>
-#include <string>
+#include <algorithm>
+#include <array>
+#include <charconv>
+#include <cstddef>
+#include <cstdint>
+#include <future>
+#include <string_view>
+#include <system_error>
+#include <vector>
+
+namespace {
+
+enum class field { byr, iyr, eyr, hgt, hcl, ecl, pid, cid };
+
+constexpr unsigned field_bit(field f)
+{
+    return 1u << static_cast<unsigned>(f);
+}
 
-namespace rs = ranges;
-namespace rv = ranges::views;
+// Every field except cid.
+constexpr unsigned required_fields = field_bit(field::cid) - 1;
 
-struct field_t {
-    std::string tag;
-    std::string data;
+// Minimal perfect hash of the eight tags onto [0, 8).
+constexpr std::size_t tag_slot(std::string_view tag)
+{
+    auto c = [&tag](std::size_t i) { return static_cast<unsigned>(static_cast<unsigned char>(tag[i])); };
+    return ((2 * c(0) + 4 * c(1) + 3 * c(2)) >> 2) % 8;
+}
+
+struct tag_entry {
+    std::string_view tag;
+    field            id;
 };
 
-auto combine_chars        = [](auto const& rc) { return rc | rs::to<std::string>; };
-auto to_passport_field    = [](const auto& s) { return field_t{s.substr(0, 3), s.substr(4)}; };
-auto is_valid_part1_field = [](const field_t& f) { return f.tag != "cid"; };
-auto is_valid_part2_field = [](const field_t& f) {
-    if (f.tag == "cid") { return false; }
-    else if (f.tag == "byr") {
-        int d = std::stoi(f.data);
-        return d >= 1920 && d <= 2002;
-    }
-    else if (f.tag == "iyr") {
-        int d = std::stoi(f.data);
-        return d >= 2010 && d <= 2020;
-    }
-    else if (f.tag == "eyr") {
-        int d = std::stoi(f.data);
-        return d >= 2020 && d <= 2030;
-    }
-    else if (f.tag == "hgt") {
+// Indexed by tag_slot; the stored tag is compared so unknown tags miss. Building it fails to compile
+// if two tags ever share a slot.
+constexpr auto tag_table = [] {
+    constexpr std::array<std::string_view, 8> tags{
+        "byr", "iyr", "eyr", "hgt", "hcl", "ecl", "pid", "cid"};
+
+    std::array<tag_entry, 8> table{};
 
-        std::string unit = f.data.substr(f.data.length() - 2);
-        if (unit != "in" && unit != "cm") return false;
+    for (std::size_t i = 0; i < tags.size(); ++i) {
+        auto& entry = table[tag_slot(tags[i])];
 
-        int h = std::stoi(f.data.substr(0, f.data.length() - 2));
-        return (unit == "cm" && h >= 150 && h <= 193) || (unit == "in" && h >= 59 && h <= 76);
+        if (!entry.tag.empty()) throw "passport tags collide";
+        entry = {tags[i], static_cast<field>(i)};
     }
-    else if (f.tag == "hcl") {
-        if (f.data.length() != 7) return false;
 
-        if (f.data[0] != '#') return false;
+    return table;
+}();
 
-        for (auto c : f.data.substr(1)) {
-            if (!(c >= '0' && c <= '9') && !(c >= 'a' && c <= 'f')) return false;
-        }
+struct passport_tally {
+    int part1 = 0;
+    int part2 = 0;
+};
+
+bool is_digit(char c)
+{
+    return c >= '0' && c <= '9';
+}
+
+bool is_number_between(std::string_view digits, int low, int high)
+{
+    int         value = 0;
+    const char* last  = digits.data() + digits.size();
+
+    auto [end, error] = std::from_chars(digits.data(), last, value);
+    return error == std::errc{} && end == last && value >= low && value <= high;
+}
+
+bool is_valid_value(field f, std::string_view value)
+{
+    constexpr std::array<std::string_view, 7> eye_colors{
+        "amb", "blu", "brn", "gry", "grn", "hzl", "oth"};
+
+    auto is_hex = [](char c) { return is_digit(c) || (c >= 'a' && c <= 'f'); };
+
+    switch (f) {
+    case field::byr: return value.size() == 4 && is_number_between(value, 1920, 2002);
+    case field::iyr: return value.size() == 4 && is_number_between(value, 2010, 2020);
+    case field::eyr: return value.size() == 4 && is_number_between(value, 2020, 2030);
+    case field::hgt: {
+        auto number = value.substr(0, value.size() - std::min<std::size_t>(value.size(), 2));
+
+        if (value.ends_with("cm")) return is_number_between(number, 150, 193);
+        if (value.ends_with("in")) return is_number_between(number, 59, 76);
+        return false;
     }
-    else if (f.tag == "ecl") {
-        return f.data == "amb" || f.data == "blu" || f.data == "brn" || f.data == "gry"
-               || f.data == "grn" || f.data == "hzl" || f.data == "oth";
+    case field::hcl:
+        return value.size() == 7 && value[0] == '#'
+               && std::all_of(value.begin() + 1, value.end(), is_hex);
+    case field::ecl: return std::find(eye_colors.begin(), eye_colors.end(), value) != eye_colors.end();
+    case field::pid: return value.size() == 9 && std::all_of(value.begin(), value.end(), is_digit);
+    case field::cid: return true;
     }
-    else if (f.tag == "pid") {
-        if (f.data.length() != 9) return false;
 
-        for (auto c : f.data) {
-            if (c < '0' || c > '9') return false;
-        }
-    }
+    return false;
+}
 
-    return true;
-};
+// Marks one "tag:value" token in the present and valid masks; anything else is ignored.
+void scan_field(std::string_view token, unsigned& present, unsigned& valid)
+{
+    if (token.size() < 4 || token[3] != ':') return;
+
+    auto tag   = token.substr(0, 3);
+    auto entry = tag_table[tag_slot(tag)];
+
+    if (entry.tag != tag) return;
+
+    present |= field_bit(entry.id);
+    if (is_valid_value(entry.id, token.substr(4))) valid |= field_bit(entry.id);
+}
 
-int part1(const std::vector<std::string>& lines)
+// Byte-level scan of the whole batch that answers both parts in one pass. Passports end at a blank
+// line or the end of the buffer, and no field is copied out of the buffer.
+passport_tally validate_passports(std::string_view buffer)
 {
-    int passports = 0;
+    passport_tally tally;
 
-    size_t fields = 0;
+    unsigned present = 0;
+    unsigned valid   = 0;
 
-    for (const auto& str : lines) {
-        if (str.length() == 0) {
-            if (fields == 7) ++passports;
+    auto finish_passport = [&] {
+        tally.part1 += (present & required_fields) == required_fields;
+        tally.part2 += (valid & required_fields) == required_fields;
+        present = valid = 0;
+    };
 
-            fields = 0;
+    const char* p    = buffer.data();
+    const char* last = p + buffer.size();
+
+    bool blank_line = true;
+
+    while (p != last) {
+        if (*p == '\n') {
+            if (blank_line) finish_passport();
+            blank_line = true;
+            ++p;
+            continue;
         }
-        else {
-            // clang-format off
-            fields += rs::distance(str 
-                | rv::split(' ') 
-                | rv::transform(combine_chars)
-                | rv::transform(to_passport_field)
-                | rv::filter(is_valid_part1_field));
-            // clang-format on
+
+        if (*p == ' ' || *p == '\r') {
+            ++p;
+            continue;
+        }
+
+        const char* token = p;
+        while (p != last && *p != ' ' && *p != '\n' && *p != '\r') {
+            ++p;
         }
+
+        scan_field({token, static_cast<std::size_t>(p - token)}, present, valid);
+        blank_line = false;
     }
 
-    return passports;
+    finish_passport();
+
+    return tally;
 }
 
-int part2(const std::vector<std::string>& lines)
+// Offset just past the first blank line starting at or after from, or the end of the buffer.
+std::size_t next_record_boundary(std::string_view buffer, std::size_t from)
 {
-    int    passports = 0;
-    size_t fields    = 0;
+    for (auto pos = buffer.find('\n', from); pos != std::string_view::npos;) {
+        auto next = pos + 1;
 
-    for (const auto& str : lines) {
-        if (str.length() == 0) {
-            if (fields == 7) ++passports;
+        if (next < buffer.size() && buffer[next] == '\r') ++next;
+        if (next < buffer.size() && buffer[next] == '\n') return next + 1;
 
-            fields = 0;
-        }
-        else {
-            // clang-format off
-            fields += rs::distance(str 
-                | rv::split(' ') 
-                | rv::transform(combine_chars)
-                | rv::transform(to_passport_field)
-                | rv::filter(is_valid_part2_field));
-            // clang-format on
-        }
+        pos = buffer.find('\n', next);
     }
 
-    return passports;
+    return buffer.size();
 }
 
-#ifndef UNIT_TESTING
-
-int main()
+// Splits buffer into about chunks pieces, each cut just after a blank line so no passport straddles
+// two of them, and validates the pieces concurrently on pool.
+passport_tally
+validate_passports_parallel(std::string_view buffer, std::size_t chunks, aoc::thread_pool& pool)
 {
-    fmt::print("Advent of Code 2020 - Day 04\n");
+    std::vector<std::future<passport_tally>> results;
+
+    auto chunk_size = buffer.size() / std::max<std::size_t>(chunks, 1) + 1;
+
+    for (std::size_t first = 0; first < buffer.size();) {
+        auto last  = next_record_boundary(buffer, std::min(first + chunk_size, buffer.size()));
+        auto chunk = buffer.substr(first, last - first);
+
+        results.push_back(pool.submit([chunk] { return validate_passports(chunk); }));
+        first = last;
+    }
+
+    passport_tally tally;
 
-    std::ifstream ifs{"days/day04/puzzle.in"};
+    for (auto& result : results) {
+        auto counts = result.get();
+        tally.part1 += counts.part1;
+        tally.part2 += counts.part2;
+    }
+
+    return tally;
+}
+
+// Batches below one chunk's worth are scanned on the calling thread. Larger ones are cut into a few
+// chunks per worker of the shared pool so uneven chunks still balance out.
+constexpr std::size_t min_chunk_bytes = std::size_t{1} << 20;
+
+passport_tally count_valid_passports(std::string_view buffer)
+{
+    auto& pool   = aoc::shared_pool();
+    auto  chunks = std::min<std::size_t>(buffer.size() / min_chunk_bytes, 4 * pool.size());
 
-    auto input = ranges::getlines(ifs) | ranges::to<std::vector>;
+    return chunks > 1 ? validate_passports_parallel(buffer, chunks, pool) : validate_passports(buffer);
+}
 
-    fmt::print("Part 1 Solution: {}\n", part1(input));
-    fmt::print("Part 2 Solution: {}\n", part2(input));
+int part1(const passport_tally& input)
+{
+    return input.part1;
+}
 
-    return 0;
+int part2(const passport_tally& input)
+{
+    return input.part2;
 }
 
-#else
+const aoc::day_registrar registrar{
+    4,
+    [](const auto& input_path) { return count_valid_passports(aoc::mapped_input{input_path}.view()); },
+    part1,
+    part2};
+
+} // namespace
+
+#ifdef UNIT_TESTING
 
 #define CATCH_CONFIG_MAIN
 #include <catch2/catch.hpp>
-#include <sstream>
+#include <string>
 
-TEST_CASE("Can solve day 4 problems")
+TEST_CASE("Can validate passport fields")
 {
-    std::stringstream ss;
+    REQUIRE(is_valid_value(field::byr, "2002"));
+    REQUIRE_FALSE(is_valid_value(field::byr, "2003"));
+
+    REQUIRE(is_valid_value(field::hgt, "60in"));
+    REQUIRE(is_valid_value(field::hgt, "190cm"));
+    REQUIRE_FALSE(is_valid_value(field::hgt, "190in"));
+    REQUIRE_FALSE(is_valid_value(field::hgt, "190"));
+    REQUIRE_FALSE(is_valid_value(field::hgt, "in"));
 
-    ss << R"(ecl:gry pid:860033327 eyr:2020 hcl:#fffffd
+    REQUIRE(is_valid_value(field::hcl, "#123abc"));
+    REQUIRE_FALSE(is_valid_value(field::hcl, "#123abz"));
+    REQUIRE_FALSE(is_valid_value(field::hcl, "123abc"));
+
+    REQUIRE(is_valid_value(field::ecl, "brn"));
+    REQUIRE_FALSE(is_valid_value(field::ecl, "wat"));
+
+    REQUIRE(is_valid_value(field::pid, "000000001"));
+    REQUIRE_FALSE(is_valid_value(field::pid, "0123456789"));
+}
+
+TEST_CASE("Can solve day 4 problems")
+{
+    constexpr std::string_view example = R"(ecl:gry pid:860033327 eyr:2020 hcl:#fffffd
 byr:1937 iyr:2017 cid:147 hgt:183cm
 
 iyr:2013 ecl:amb cid:350 eyr:2023 pid:028048884
@@ -152,11 +280,46 @@ hgt:179cm
 hcl:#cfa07d eyr:2025 pid:166559648
 iyr:2011 ecl:brn hgt:59in)";
 
-    auto input = ranges::getlines(ss) | ranges::to<std::vector>;
+    auto input = validate_passports(example);
 
     SECTION("Can solve part 1 example") { REQUIRE(2 == part1(input)); }
 
     SECTION("Can solve part 2 example") { REQUIRE(2 == part2(input)); }
+
+    SECTION("Counts the last passport and accepts CRLF line endings")
+    {
+        auto crlf = validate_passports(
+            "pid:087499704 hgt:74in ecl:grn iyr:2012 eyr:2030 byr:1980\r\n"
+            "hcl:#623a2f\r\n"
+            "\r\n"
+            "eyr:1972 cid:100\r\n"
+            "hcl:#18171d ecl:amb hgt:170 pid:186cm iyr:2018 byr:1926\r\n"
+            "\r\n"
+            "iyr:2010 hgt:158cm hcl:#b6652a ecl:blu byr:1944 eyr:2021 pid:093154719");
+
+        REQUIRE(3 == part1(crlf));
+        REQUIRE(2 == part2(crlf));
+    }
+
+    SECTION("Splits batches between passports")
+    {
+        std::string batch;
+        for (int i = 0; i < 50; ++i) {
+            batch += example;
+            batch += i % 2 == 0 ? "\n\n" : "\r\n\r\n\r\n";
+        }
+
+        for (std::size_t threads : {1, 4}) {
+            aoc::thread_pool pool{threads};
+
+            for (std::size_t chunks : {1, 2, 3, 7, 64, 1000}) {
+                auto tally = validate_passports_parallel(batch, chunks, pool);
+
+                REQUIRE(100 == part1(tally));
+                REQUIRE(100 == part2(tally));
+            }
+        }
+    }
 }
 
 #endif
@@ -1,4 +1,5 @@
-#include <fmt/core.h>
+#include <aoc2020/aoc2020.hpp>
+#include <aoc2020/registry.hpp>
 
 #ifdef _MSC_VER
 #pragma warning(push)
@@ -9,57 +10,167 @@
 #pragma warning(pop)
 #endif
 
+#include <bit>
 #include <bitset>
-#include <fstream>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <span>
+#include <stdexcept>
+#include <string_view>
+#include <vector>
+
+#if defined(__BMI2__)
+#include <immintrin.h>
+#endif
 
 namespace rs = ranges;
 namespace rv = ranges::views;
 
-int calculate_seat_id(std::string_view pass)
+namespace {
+
+constexpr std::size_t pass_length = 10;
+
+// Bit 2 of every byte is set for F and L and clear for B and R.
+constexpr uint64_t lower_half_bits = 0x0404040404040404;
+
+#if defined(__BMI2__)
+constexpr uint64_t byteswap64(uint64_t x)
 {
-    auto to_bits = [](char c) {
-        if (c == 'F' || c == 'L') return '0';
-        else
-            return '1';
-    };
+    x = ((x & 0x00ff00ff00ff00ff) << 8) | ((x >> 8) & 0x00ff00ff00ff00ff);
+    x = ((x & 0x0000ffff0000ffff) << 16) | ((x >> 16) & 0x0000ffff0000ffff);
+    return (x << 32) | (x >> 32);
+}
+#endif
 
-    return std::bitset<10>(pass | rv::transform(to_bits) | rs::to<std::string>).to_ulong();
+// The ten characters of a pass are the seat id's bits, most significant first. The first eight are
+// loaded as one little-endian word and their bits gathered with pext, or with a multiply that
+// moves byte i's bit to bit 7 - i of the top byte.
+int calculate_seat_id(const char* pass)
+{
+    if constexpr (std::endian::native != std::endian::little) {
+        int id = 0;
+        for (std::size_t i = 0; i < pass_length; ++i) {
+            id = (id << 1) | ((pass[i] & 0x04) == 0);
+        }
+        return id;
+    }
+
+    uint64_t head;
+    uint16_t tail;
+    std::memcpy(&head, pass, sizeof(head));
+    std::memcpy(&tail, pass + sizeof(head), sizeof(tail));
+
+#if defined(__BMI2__)
+    auto high = static_cast<uint32_t>(_pext_u64(byteswap64(~head), lower_half_bits));
+#else
+    auto high = static_cast<uint32_t>(((((~head & lower_half_bits) >> 2) * 0x8040201008040201) >> 56));
+#endif
+    auto low = static_cast<uint32_t>(~tail & 0x0404);
+
+    return static_cast<int>((high << 2) | ((low >> 1) & 0x2) | (low >> 10));
 }
 
-int64_t part1(const std::vector<int>& input)
+// True when the ten characters at pass are seven F or B followed by three L or R. Every byte has to
+// be B or R when its bit 2 is clear and F or L when it is set, so the expected word is the all-B/R
+// pass with the B^F or R^L difference applied to the bytes that have bit 2 set.
+bool is_valid_pass(const char* pass)
 {
-    return rs::max(input);
+    if constexpr (std::endian::native != std::endian::little) {
+        for (std::size_t i = 0; i < pass_length; ++i) {
+            const char* letters = i < 7 ? "FB" : "LR";
+            if (pass[i] != letters[0] && pass[i] != letters[1]) return false;
+        }
+        return true;
+    }
+
+    constexpr uint64_t upper_head = 0x5242424242424242; // BBBBBBBR
+    constexpr uint64_t flip_head  = 0x1e04040404040404;
+    constexpr uint16_t upper_tail = 0x5252; // RR
+    constexpr uint16_t flip_tail  = 0x1e1e;
+
+    uint64_t head;
+    uint16_t tail;
+    std::memcpy(&head, pass, sizeof(head));
+    std::memcpy(&tail, pass + sizeof(head), sizeof(tail));
+
+    // 0xff in every byte with bit 2 set, 0 elsewhere.
+    auto head_lower = ((head & lower_half_bits) >> 2) * 0xff;
+    auto tail_lower = static_cast<uint16_t>(((tail & 0x0404) >> 2) * 0xff);
+
+    return head == (upper_head ^ (head_lower & flip_head))
+           && tail == (upper_tail ^ (tail_lower & flip_tail));
 }
 
-int64_t part2(const std::vector<int>& input)
+// Decodes one pass per line of buffer into out and returns the number written, at most out.size().
+// Every line has to be exactly ten F/B/L/R characters; anything else throws std::runtime_error.
+std::size_t decode_seat_ids(std::string_view buffer, std::span<int> out)
 {
-    auto [min_id, max_id] = rs::minmax(input);
-    auto sum              = rs::accumulate(input, 0);
+    const char* p     = buffer.data();
+    const char* last  = p + buffer.size();
+    std::size_t count = 0;
+
+    while (count < out.size()) {
+        while (p != last && (*p == '\n' || *p == '\r')) {
+            ++p;
+        }
+
+        if (p == last) break;
+        auto remaining = static_cast<std::size_t>(last - p);
 
-    return ((input.size() + 1) * (min_id + max_id) / 2) - sum;
+        if (remaining < pass_length || !is_valid_pass(p)
+            || (remaining > pass_length && p[pass_length] != '\n' && p[pass_length] != '\r')) {
+            throw std::runtime_error{"Invalid input received"};
+        }
+
+        out[count++] = calculate_seat_id(p);
+        p += pass_length;
+    }
+
+    return count;
 }
 
-#ifndef UNIT_TESTING
+std::vector<int> read_seat_ids(std::string_view buffer)
+{
+    std::vector<int> ids(aoc::count_lines(buffer));
+    ids.resize(decode_seat_ids(buffer, ids));
+    return ids;
+}
 
-int main()
+int64_t part1(const std::vector<int>& input)
 {
-    fmt::print("Advent of Code 2020 - Day 05\n");
+    return rs::max(input);
+}
 
-    std::ifstream ifs{"days/day05/puzzle.in"};
+// Marks every taken seat in a bitmap and returns the first free one whose neighbours are taken, so
+// any number of other gaps is fine.
+int64_t part2(const std::vector<int>& input)
+{
+    std::bitset<1024> taken;
 
-    auto input = rs::getlines(ifs) | rv::transform(calculate_seat_id) | rs::to<std::vector<int>>;
+    for (int id : input) {
+        taken.set(static_cast<std::size_t>(id));
+    }
 
-    fmt::print("Part 1 Solution: {}\n", part1(input));
-    fmt::print("Part 2 Solution: {}\n", part2(input));
+    for (std::size_t id = 1; id + 1 < taken.size(); ++id) {
+        if (!taken[id] && taken[id - 1] && taken[id + 1]) return static_cast<int64_t>(id);
+    }
 
-    return 0;
+    throw std::runtime_error{"No free seat between two taken ones"};
 }
 
-#else
+const aoc::day_registrar registrar{
+    5,
+    [](const auto& input_path) { return read_seat_ids(aoc::mapped_input{input_path}.view()); },
+    part1,
+    part2};
+
+} // namespace
+
+#ifdef UNIT_TESTING
 
 #define CATCH_CONFIG_MAIN
 #include <catch2/catch.hpp>
-#include <sstream>
 
 TEST_CASE("Can calculate seat id from boarding pass", "[day05]")
 {
@@ -67,6 +178,34 @@ TEST_CASE("Can calculate seat id from boarding pass", "[day05]")
     REQUIRE(567 == calculate_seat_id("BFFFBBFRRR"));
     REQUIRE(119 == calculate_seat_id("FFFBBBFRRR"));
     REQUIRE(820 == calculate_seat_id("BBFFBBFRLL"));
+    REQUIRE(0 == calculate_seat_id("FFFFFFFLLL"));
+    REQUIRE(1023 == calculate_seat_id("BBBBBBBRRR"));
+}
+
+TEST_CASE("Can solve day 5 problems", "[day05]")
+{
+    auto input = read_seat_ids("FBFBBFFRLR\nBFFFBBFRRR\r\nFFFBBBFRRR\nBBFFBBFRLL\n");
+
+    REQUIRE(std::vector{357, 567, 119, 820} == input);
+    REQUIRE(820 == part1(input));
+
+    SECTION("Rejects malformed passes")
+    {
+        REQUIRE(std::vector{357} == read_seat_ids("FBFBBFFRLR"));
+
+        REQUIRE_THROWS_AS(read_seat_ids("FBFBBFFRLRL\nBFFFBBFRRR\n"), std::runtime_error);
+        REQUIRE_THROWS_AS(read_seat_ids("FBFBBFFRL\nBFFFBBFRRR\n"), std::runtime_error);
+        REQUIRE_THROWS_AS(read_seat_ids("FBFBBFFRLX\n"), std::runtime_error);
+        REQUIRE_THROWS_AS(read_seat_ids("FBFBBFLRLR\n"), std::runtime_error);
+        REQUIRE_THROWS_AS(read_seat_ids("FBFBBFFRFR\n"), std::runtime_error);
+        REQUIRE_THROWS_AS(read_seat_ids("fbfbbffrlr\n"), std::runtime_error);
+    }
+
+    SECTION("Finds the seat between two taken ones despite other gaps")
+    {
+        REQUIRE(12 == part2(std::vector{3, 4, 5, 8, 9, 10, 11, 13, 14, 20}));
+        REQUIRE_THROWS(part2(std::vector{3, 4, 7, 8}));
+    }
 }
 
 #endif
@@ -1,80 +1,101 @@
+#include <aoc2020/aoc2020.hpp>
+#include <aoc2020/registry.hpp>
 
-#include <fmt/core.h>
-#include <range/v3/all.hpp>
+#include <bit>
+#include <cstdint>
+#include <stdexcept>
+#include <string_view>
 
-#include <fstream>
-#include <iostream>
-#include <set>
-#include <string>
+namespace {
 
-namespace rs = ranges;
-namespace ra = ranges::actions;
-namespace rv = ranges::views;
+constexpr uint32_t all_answers = (uint32_t{1} << 26) - 1;
 
-std::vector<std::string> parse_input(std::istream&& input)
+// One bit per question a-z answered on the line.
+uint32_t answer_mask(std::string_view line)
 {
-    // clang-format off
-    return rs::getlines(input) 
-        | rv::transform([](auto && s) { rs::sort(s); return s; })
-        | ranges::to<std::vector>;
-    // clang-format on
+    uint32_t mask = 0;
+
+    for (char c : line) {
+        if (c < 'a' || c > 'z') throw std::runtime_error{"Invalid input received"};
+        mask |= uint32_t{1} << (c - 'a');
+    }
+
+    return mask;
 }
 
-int64_t part1(const std::vector<std::string>& input)
+// Calls on_group(anyone, everyone) with the union and intersection of every blank-line separated
+// group's answer masks. Lines are folded in as they are read and never stored.
+template <typename F>
+void for_each_group(std::string_view buffer, F&& on_group)
 {
-    // clang-format off
-    auto rng = input 
-        | rv::split("") 
-        | rv::transform([](auto&& rng) { 
-            return rs::distance(rng | rv::join | rs::to<std::vector> | ra::sort | ra::unique); });
-    // clang-format on
-
-    return rs::accumulate(rng, int64_t{0});
+    uint32_t anyone   = 0;
+    uint32_t everyone = all_answers;
+    bool     open     = false;
+
+    for (auto line : aoc::lines(buffer)) {
+        if (line.empty()) {
+            if (open) on_group(anyone, everyone);
+
+            anyone   = 0;
+            everyone = all_answers;
+            open     = false;
+            continue;
+        }
+
+        auto mask = answer_mask(line);
+        anyone |= mask;
+        everyone &= mask;
+        open = true;
+    }
+
+    if (open) on_group(anyone, everyone);
 }
 
-int64_t part2(const std::vector<std::string>& input)
-{
-    // clang-format off
-    auto rng = input 
-        | rv::split("") 
-        | rv::transform([](auto&& rng) {
-            auto first = rs::front(rng) | rs::to<std::vector>;
+struct answer_tally {
+    int64_t part1 = 0;
+    int64_t part2 = 0;
+};
 
-            for (auto s : rv::tail(rng)) {
-                first = rv::set_intersection(first, s) | rs::to<std::vector>;
-            }
+answer_tally tally_answers(std::string_view buffer)
+{
+    answer_tally tally;
 
-            return rs::distance(first); });
-    // clang-format on
+    for_each_group(buffer, [&tally](uint32_t anyone, uint32_t everyone) {
+        tally.part1 += std::popcount(anyone);
+        tally.part2 += std::popcount(everyone);
+    });
 
-    return rs::accumulate(rng, int64_t{0});
+    return tally;
 }
 
-#ifndef UNIT_TESTING
-
-int main()
+int64_t part1(const answer_tally& tally)
 {
-    fmt::print("Advent of Code 2020 - Day 06\n");
+    return tally.part1;
+}
 
-    auto input = parse_input(std::ifstream{"days/day06/puzzle.in"});
+int64_t part2(const answer_tally& tally)
+{
+    return tally.part2;
+}
 
-    fmt::print("Part 1 Solution: {}\n", part1(input));
-    fmt::print("Part 2 Solution: {}\n", part2(input));
+const aoc::day_registrar registrar{
+    6,
+    [](const auto& input_path) { return tally_answers(aoc::mapped_input{input_path}.view()); },
+    part1,
+    part2};
 
-    return 0;
-}
+} // namespace
 
-#else
+#ifdef UNIT_TESTING
 
 #define CATCH_CONFIG_MAIN
 #include <catch2/catch.hpp>
-#include <sstream>
+#include <utility>
+#include <vector>
 
 TEST_CASE("Can solve day 6 problems")
 {
-    std::stringstream ss;
-
-    ss << R"(abc
+    constexpr std::string_view example = R"(abc
 
 a
 b
@@ -90,11 +111,34 @@ a
 
 b)";
 
-    auto input = parse_input(std::move(ss));
+    auto input = tally_answers(example);
 
     SECTION("Can solve part 1 example") { REQUIRE(11 == part1(input)); }
 
     SECTION("Can solve part 2 example") { REQUIRE(6 == part2(input)); }
+
+    SECTION("Folds every group into answer masks")
+    {
+        std::vector<std::pair<uint32_t, uint32_t>> groups;
+        for_each_group(example, [&groups](uint32_t anyone, uint32_t everyone) {
+            groups.emplace_back(anyone, everyone);
+        });
+
+        REQUIRE(5 == groups.size());
+        REQUIRE(std::pair{0b111u, 0b111u} == groups[0]);
+        REQUIRE(std::pair{0b111u, 0u} == groups[1]);
+        REQUIRE(std::pair{0b111u, 0b1u} == groups[2]);
+        REQUIRE(std::pair{0b1u, 0b1u} == groups[3]);
+        REQUIRE(std::pair{answer_mask("b"), answer_mask("b")} == groups[4]);
+    }
+
+    SECTION("Handles CRLF and repeated blank lines")
+    {
+        auto tally = tally_answers("ab\r\nb\r\n\r\n\r\nxyz\r\n");
+        REQUIRE(5 == part1(tally));
+        REQUIRE(4 == part2(tally));
+        REQUIRE_THROWS(tally_answers("aB\n"));
+    }
 }
 
 #endif
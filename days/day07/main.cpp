@@ -1,132 +1,345 @@
+#include <aoc2020/aoc2020.hpp>
+#include <aoc2020/registry.hpp>
 
-#include <fmt/core.h>
-#include <range/v3/all.hpp>
+#include <fmt/format.h>
 
-#include <fstream>
-#include <iostream>
+#include <algorithm>
+#include <charconv>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <numeric>
 #include <optional>
-#include <regex>
+#include <span>
+#include <stdexcept>
 #include <string>
-#include <unordered_map>
+#include <string_view>
+#include <system_error>
 #include <vector>
 
-namespace rs = ranges;
-namespace rv = ranges::views;
+namespace {
 
-const auto search_regex   = std::regex(R"((.*) bags contain (.*))");
-const auto contents_regex = std::regex(R"((\d+) (.*?) bag)");
+// Dense ids for bag names, in order of first appearance. Names are packed back to back into one
+// buffer and found through an open-addressing table of ids kept at most half full.
+class bag_names {
+public:
+    uint32_t intern(std::string_view name)
+    {
+        if (2 * (size() + 1) > slots_.size()) grow();
+
+        auto hash = hash_of(name);
+
+        for (auto slot = hash & (slots_.size() - 1);; slot = (slot + 1) & (slots_.size() - 1)) {
+            if (slots_[slot] == 0) {
+                auto id = static_cast<uint32_t>(size());
+
+                text_.append(name);
+                ends_.push_back(text_.size());
+                hashes_.push_back(hash);
+                slots_[slot] = id + 1;
+                return id;
+            }
+
+            auto id = slots_[slot] - 1;
+            if (hashes_[id] == hash && this->name(id) == name) return id;
+        }
+    }
+
+    std::optional<uint32_t> find(std::string_view name) const
+    {
+        if (slots_.empty()) return std::nullopt;
+
+        auto hash = hash_of(name);
+
+        for (auto slot = hash & (slots_.size() - 1); slots_[slot] != 0;
+             slot = (slot + 1) & (slots_.size() - 1)) {
+            auto id = slots_[slot] - 1;
+            if (hashes_[id] == hash && this->name(id) == name) return id;
+        }
+
+        return std::nullopt;
+    }
+
+    std::string_view name(uint32_t id) const
+    {
+        auto begin = id == 0 ? 0 : ends_[id - 1];
+        return std::string_view{text_}.substr(begin, ends_[id] - begin);
+    }
+
+    std::size_t size() const noexcept { return ends_.size(); }
+
+private:
+    static std::size_t hash_of(std::string_view name) noexcept
+    {
+        return std::hash<std::string_view>{}(name);
+    }
+
+    void grow()
+    {
+        std::vector<uint32_t> slots(std::max<std::size_t>(64, 2 * slots_.size()), 0);
+
+        for (uint32_t id = 0; id < size(); ++id) {
+            auto slot = hashes_[id] & (slots.size() - 1);
+            while (slots[slot] != 0) {
+                slot = (slot + 1) & (slots.size() - 1);
+            }
+            slots[slot] = id + 1;
+        }
+
+        slots_ = std::move(slots);
+    }
 
-struct contained {
-    std::string name;
-    int         count;
+    std::string              text_;
+    std::vector<std::size_t> ends_;
+    std::vector<std::size_t> hashes_;
+    std::vector<uint32_t>    slots_;
 };
 
-struct node {
-    std::string            name;
-    std::vector<contained> children;
+struct bag_edge {
+    uint32_t from;
+    uint32_t to;
+    uint32_t count;
 };
 
-bool can_contain_type(const std::vector<node>& nodes, const node& check, const std::string& search_type)
+// Edges in compressed sparse row form: the edges of bag i are entries offsets[i] up to
+// offsets[i + 1] of targets and counts.
+struct adjacency {
+    std::vector<uint32_t> offsets;
+    std::vector<uint32_t> targets;
+    std::vector<uint32_t> counts;
+
+    std::span<const uint32_t> targets_of(uint32_t bag) const
+    {
+        return std::span{targets}.subspan(offsets[bag], offsets[bag + 1] - offsets[bag]);
+    }
+
+    std::span<const uint32_t> counts_of(uint32_t bag) const
+    {
+        return std::span{counts}.subspan(offsets[bag], offsets[bag + 1] - offsets[bag]);
+    }
+};
+
+// Counting sort of edges by their source, or by their destination when reverse is set.
+adjacency build_adjacency(std::size_t bags, std::span<const bag_edge> edges, bool reverse)
 {
-    if (rs::find_if(check.children, [&search_type](const auto& c) { return c.name == search_type; })
-        != rs::end(check.children)) {
-        return true;
+    adjacency graph;
+    graph.offsets.assign(bags + 1, 0);
+    graph.targets.resize(edges.size());
+    graph.counts.resize(edges.size());
+
+    for (const auto& edge : edges) {
+        ++graph.offsets[(reverse ? edge.to : edge.from) + 1];
     }
 
-    for (const auto& child : check.children) {
-        auto iter = rs::find_if(nodes, [&child](const auto& n) { return n.name == child.name; });
+    std::partial_sum(graph.offsets.begin(), graph.offsets.end(), graph.offsets.begin());
 
-        if (iter != rs::end(nodes)) {
-            if (can_contain_type(nodes, *iter, search_type)) return true;
-        }
+    std::vector<uint32_t> next(graph.offsets.begin(), graph.offsets.end() - 1);
+
+    for (const auto& edge : edges) {
+        auto slot = next[reverse ? edge.to : edge.from]++;
+
+        graph.targets[slot] = reverse ? edge.from : edge.to;
+        graph.counts[slot]  = edge.count;
     }
 
-    return false;
+    return graph;
 }
 
-int count_children(const std::vector<node>& nodes, const node& check, int times)
+struct bag_rules {
+    bag_names             names;
+    std::vector<bag_edge> edges;
+};
+
+// The rule grammar is "<adjective> <color> bags contain " followed by "no other bags." or by
+// "N <adjective> <color> bag(s)" entries separated with ", " and ended with ".". Each helper consumes
+// one token from the front of rest and throws when it isn't there.
+void expect(std::string_view& rest, std::string_view token)
 {
-    int sum = 0;
-    for (const auto& child : check.children) {
-        sum += (child.count * times);
+    if (!rest.starts_with(token)) throw std::runtime_error{"Invalid input received"};
+    rest.remove_prefix(token.size());
+}
 
-        auto iter = rs::find_if(nodes, [&child](const auto& n) { return n.name == child.name; });
+std::string_view read_name(std::string_view& rest)
+{
+    auto adjective_end = rest.find(' ');
+    auto color_end     = adjective_end == std::string_view::npos ? adjective_end
+                                                                 : rest.find(' ', adjective_end + 1);
 
-        if (iter != rs::end(nodes)) { sum += count_children(nodes, *iter, times * child.count); }
+    if (adjective_end == 0 || color_end == std::string_view::npos || color_end == adjective_end + 1) {
+        throw std::runtime_error{"Invalid input received"};
     }
 
-    return sum;
+    auto name = rest.substr(0, color_end);
+    rest.remove_prefix(color_end);
+    return name;
 }
 
-std::vector<node> parse_input(std::istream&& is)
+uint32_t read_count(std::string_view& rest)
 {
-    // clang-format off
-    return rs::getlines(is) 
-        | rv::transform([](auto&& s) {
-            std::smatch         m, m2;
-            std::optional<node> n;
-
-            if (std::regex_match(s, m, search_regex)) {
-                n = node{m.str(1), {}};
-
-                for (auto tmp = m.str(2); std::regex_search(tmp, m2, contents_regex);) {
-                    n->children.push_back({m2.str(2), std::stoi(m2.str(1))});
-                    tmp = m2.suffix();
-                }
-            }
+    uint32_t count = 0;
+    auto [ptr, ec] = std::from_chars(rest.data(), rest.data() + rest.size(), count);
 
-            return n.value(); })
-        | rs::to<std::vector>;
-    // clang-format on
-}
+    if (ec != std::errc{}) throw std::runtime_error{"Invalid input received"};
 
-int64_t part1(const std::vector<node>& input, const std::string& bag_type)
-{
-    // clang-format off
-    auto nodes = input
-        | rv::filter([&input, &bag_type](const auto& n) {
-            return n.name != bag_type && can_contain_type(input, n, bag_type); })
-        | rv::transform([](auto&& n) { return n.name; })
-        | rv::unique;
-    // clang-format on
-
-    return rs::distance(nodes);
+    rest.remove_prefix(static_cast<std::size_t>(ptr - rest.data()));
+    return count;
 }
 
-int part2(const std::vector<node>& input, const std::string& bag_type)
+// Single pass over the line bytes, interning names as they are read.
+bag_rules parse_input(std::string_view buffer)
 {
-    auto wanted = input | rv::filter([&bag_type](const auto& n) { return n.name == bag_type; });
+    bag_rules rules;
+
+    for (auto line : aoc::lines(buffer)) {
+        if (line.empty()) continue;
+
+        auto rest = line;
+        auto bag  = rules.names.intern(read_name(rest));
 
-    return count_children(input, rs::front(wanted), 1);
+        expect(rest, " bags contain ");
+        if (rest == "no other bags.") continue;
+
+        for (;;) {
+            auto count = read_count(rest);
+            expect(rest, " ");
+            auto child = rules.names.intern(read_name(rest));
+            expect(rest, " bag");
+            if (rest.starts_with('s')) rest.remove_prefix(1);
+
+            rules.edges.push_back({bag, child, count});
+
+            if (rest == ".") break;
+            expect(rest, ", ");
+        }
+    }
+
+    return rules;
 }
 
-#ifndef UNIT_TESTING
+// Query engine over one parsed rule set. The bags inside every bag are totalled once, children
+// before parents, so shared sub-bags are expanded a single time. Which bags can end up holding a
+// bag is a walk up the reverse edges, batched so many targets share one scratch buffer.
+class bag_index {
+public:
+    explicit bag_index(bag_rules rules)
+        : names_{std::move(rules.names)}
+        , children_{build_adjacency(names_.size(), rules.edges, false)}
+        , parents_{build_adjacency(names_.size(), rules.edges, true)}
+        , totals_(names_.size(), 0)
+    {
+        // Kahn's algorithm on the reverse graph: a bag is ready once all of its children are.
+        std::vector<uint32_t> pending(names_.size());
+        std::vector<uint32_t> ready;
 
-int main()
-{
-    fmt::print("Advent of Code 2020 - Day 07\n");
+        for (uint32_t bag = 0; bag < names_.size(); ++bag) {
+            pending[bag] = static_cast<uint32_t>(children_.targets_of(bag).size());
+            if (pending[bag] == 0) ready.push_back(bag);
+        }
+
+        std::size_t done = 0;
+
+        while (!ready.empty()) {
+            auto bag = ready.back();
+            ready.pop_back();
+            ++done;
+
+            auto children = children_.targets_of(bag);
+            auto counts   = children_.counts_of(bag);
+
+            for (std::size_t i = 0; i < children.size(); ++i) {
+                totals_[bag] += counts[i] * (1 + totals_[children[i]]);
+            }
+
+            for (auto parent : parents_.targets_of(bag)) {
+                if (--pending[parent] == 0) ready.push_back(parent);
+            }
+        }
+
+        if (done != names_.size()) throw std::runtime_error{"Bag rules contain a cycle"};
+    }
+
+    uint32_t id(std::string_view name) const
+    {
+        auto bag = names_.find(name);
+        if (!bag) throw std::runtime_error{fmt::format("No rule mentions {} bags", name)};
+        return *bag;
+    }
 
-    auto input = parse_input(std::ifstream{"days/day07/puzzle.in"});
+    // Number of bags that end up inside one bag.
+    int64_t contained_count(uint32_t bag) const { return totals_[bag]; }
+
+    // For each of bags, the number of other bags that can eventually hold it.
+    std::vector<std::size_t> container_counts(std::span<const uint32_t> bags) const
+    {
+        std::vector<std::size_t> results;
+        std::vector<uint32_t>    visited(names_.size(), 0);
+        std::vector<uint32_t>    stack;
+
+        results.reserve(bags.size());
+
+        for (std::size_t query = 0; query < bags.size(); ++query) {
+            auto        stamp = static_cast<uint32_t>(query + 1);
+            std::size_t found = 0;
+
+            visited[bags[query]] = stamp;
+            stack.assign(1, bags[query]);
+
+            while (!stack.empty()) {
+                auto bag = stack.back();
+                stack.pop_back();
+
+                for (auto parent : parents_.targets_of(bag)) {
+                    if (visited[parent] == stamp) continue;
+
+                    visited[parent] = stamp;
+                    stack.push_back(parent);
+                    ++found;
+                }
+            }
+
+            results.push_back(found);
+        }
+
+        return results;
+    }
 
-    fmt::print("Part 1 Solution: {}\n", part1(input, "shiny gold"));
+    std::size_t container_count(uint32_t bag) const { return container_counts(std::span{&bag, 1})[0]; }
 
-    fmt::print("Part 2 Solution: {}\n", part2(input, "shiny gold"));
+    std::size_t size() const noexcept { return names_.size(); }
 
-    return 0;
+private:
+    bag_names            names_;
+    adjacency            children_;
+    adjacency            parents_;
+    std::vector<int64_t> totals_;
+};
+
+int64_t part1(const bag_index& index, std::string_view bag_type)
+{
+    return static_cast<int64_t>(index.container_count(index.id(bag_type)));
 }
 
-#else
+int64_t part2(const bag_index& index, std::string_view bag_type)
+{
+    return index.contained_count(index.id(bag_type));
+}
+
+const aoc::day_registrar registrar{
+    7,
+    [](const auto& input_path) { return bag_index{parse_input(aoc::mapped_input{input_path}.view())}; },
+    [](const auto& input) { return part1(input, "shiny gold"); },
+    [](const auto& input) { return part2(input, "shiny gold"); }};
+
+} // namespace
+
+#ifdef UNIT_TESTING
 
 #define CATCH_CONFIG_MAIN
 #include <catch2/catch.hpp>
-#include <sstream>
-
 
-TEST_CASE("Can solve day 10 problems")
+TEST_CASE("Can solve day 7 problems")
 {
-    std::stringstream ss1;
-
-    ss1 << R"(light red bags contain 1 bright white bag, 2 muted yellow bags.
+    bag_index input1{parse_input(R"(light red bags contain 1 bright white bag, 2 muted yellow bags.
 dark orange bags contain 3 bright white bags, 4 muted yellow bags.
 bright white bags contain 1 shiny gold bag.
 muted yellow bags contain 2 shiny gold bags, 9 faded blue bags.
@@ -134,29 +347,74 @@ shiny gold bags contain 1 dark olive bag, 2 vibrant plum bags.
 dark olive bags contain 3 faded blue bags, 4 dotted black bags.
 vibrant plum bags contain 5 faded blue bags, 6 dotted black bags.
 faded blue bags contain no other bags.
-dotted black bags contain no other bags.)";
-
-    auto input1 = parse_input(std::move(ss1));
+dotted black bags contain no other bags.)")};
 
     SECTION("Can solve part 1 examples") { REQUIRE(4 == part1(input1, "shiny gold")); }
 
     SECTION("Can solve part 2 examples")
     {
-        std::stringstream ss2;
-
-        ss2 << R"(shiny gold bags contain 2 dark red bags.
+        bag_index input2{parse_input(R"(shiny gold bags contain 2 dark red bags.
 dark red bags contain 2 dark orange bags.
 dark orange bags contain 2 dark yellow bags.
 dark yellow bags contain 2 dark green bags.
 dark green bags contain 2 dark blue bags.
 dark blue bags contain 2 dark violet bags.
-dark violet bags contain no other bags.)";
-
-        auto input2 = parse_input(std::move(ss2));
+dark violet bags contain no other bags.)")};
 
         REQUIRE(32 == part2(input1, "shiny gold"));
         REQUIRE(126 == part2(input2, "shiny gold"));
     }
+
+    SECTION("Answers queries for any bag from one index")
+    {
+        REQUIRE(9 == input1.size());
+
+        auto bags = std::vector{
+            input1.id("faded blue"),
+            input1.id("shiny gold"),
+            input1.id("light red"),
+            input1.id("muted yellow")};
+
+        REQUIRE(std::vector<std::size_t>{7, 4, 0, 2} == input1.container_counts(bags));
+        REQUIRE(0 == input1.contained_count(input1.id("faded blue")));
+        REQUIRE(7 == input1.contained_count(input1.id("dark olive")));
+        REQUIRE(406 == input1.contained_count(input1.id("dark orange")));
+        REQUIRE_THROWS(input1.id("plaid magenta"));
+    }
+
+    SECTION("Totals shared sub-bags once")
+    {
+        // Every level reaches the next one over two paths, so level0 holds 2^40 level40 bags.
+        std::string rules;
+        for (int level = 0; level < 40; ++level) {
+            rules += fmt::format(
+                "level{} left bags contain 1 level{} right bag, 1 level{} center bag.\n"
+                "level{} right bags contain 1 level{} left bag.\n"
+                "level{} center bags contain 1 level{} left bag.\n",
+                level, level, level, level, level + 1, level, level + 1);
+        }
+
+        bag_index deep{parse_input(rules)};
+
+        REQUIRE((int64_t{1} << 42) - 4 == part2(deep, "level0 left"));
+        REQUIRE(120 == part1(deep, "level40 left"));
+    }
+
+    SECTION("Rejects malformed rules")
+    {
+        REQUIRE_THROWS(parse_input("dim red bags contain 1 dim blue bag"));
+        REQUIRE_THROWS(parse_input("dim red bags contain one dim blue bag."));
+        REQUIRE_THROWS(parse_input("dim red bags hold 2 dim blue bags."));
+        REQUIRE_THROWS(parse_input("red bags contain no other bags."));
+        REQUIRE_THROWS(parse_input("dim red bags contain 2 dim blue bags; 1 dim tan bag."));
+        REQUIRE(1 == parse_input("dim red bags contain no other bags.\r\n").names.size());
+    }
+
+    SECTION("Rejects cyclic rules")
+    {
+        REQUIRE_THROWS(bag_index{parse_input(
+            "dim red bags contain 1 dim blue bag.\ndim blue bags contain 2 dim red bags.\n")});
+    }
 }
 
 #endif
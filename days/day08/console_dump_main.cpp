@@ -0,0 +1,204 @@
+#include "console_trace.hpp"
+
+#include <fmt/core.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <exception>
+#include <iterator>
+#include <numeric>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace {
+
+struct options {
+    std::string trace;
+    std::string record;
+    std::size_t top = 10;
+};
+
+options parse_options(int argc, char* argv[])
+{
+    options opts;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string_view arg{argv[i]};
+
+        if (arg == "--top" && i + 1 < argc) { opts.top = std::stoul(argv[++i]); }
+        else if (arg == "--record" && i + 1 < argc) {
+            opts.record = argv[++i];
+        }
+        else if (opts.trace.empty() && !arg.starts_with("--")) {
+            opts.trace = arg;
+        }
+        else {
+            throw std::invalid_argument{
+                fmt::format("usage: {} TRACE [--record INPUT] [--top N]", argv[0])};
+        }
+    }
+
+    if (opts.trace.empty()) throw std::invalid_argument{"A trace file is required"};
+
+    return opts;
+}
+
+struct block_summary {
+    uint32_t block      = 0;
+    uint32_t start      = 0;
+    uint32_t length     = 0;
+    uint64_t entries    = 0;
+    uint64_t executed   = 0;
+    uint64_t back_edges = 0;
+};
+
+// Per-block instructions executed over every recorded run, plus the part 1 run's entry counts and
+// the number of times it reached each block by a backward jump, which marks the block as the entry
+// point of a loop. When the run stopped on a repeated instruction, reaching that instruction's block
+// counts as one more backward jump.
+std::vector<block_summary> summarize(const aoc::day08::console_trace& trace)
+{
+    std::vector<block_summary> blocks(trace.block_lengths.size());
+
+    uint32_t start = 0;
+    for (uint32_t b = 0; b < blocks.size(); ++b) {
+        blocks[b].block  = b;
+        blocks[b].start  = start;
+        blocks[b].length = trace.block_lengths[b];
+
+        auto first = std::min<std::size_t>(start, trace.hits.size());
+        auto last  = std::min<std::size_t>(start + blocks[b].length, trace.hits.size());
+
+        blocks[b].executed = std::accumulate(
+            trace.hits.begin() + static_cast<std::ptrdiff_t>(first),
+            trace.hits.begin() + static_cast<std::ptrdiff_t>(last),
+            uint64_t{0});
+
+        start += blocks[b].length;
+    }
+
+    for (std::size_t i = 0; i < trace.executed_blocks.size(); ++i) {
+        auto& block = blocks[trace.executed_blocks[i]];
+        ++block.entries;
+
+        if (i > 0 && block.start <= blocks[trace.executed_blocks[i - 1]].start) ++block.back_edges;
+    }
+
+    if (trace.looped) {
+        auto stopped = std::find_if(blocks.begin(), blocks.end(), [&trace](const auto& block) {
+            return trace.stop >= block.start && trace.stop < block.start + block.length;
+        });
+
+        if (stopped != blocks.end()) ++stopped->back_edges;
+    }
+
+    return blocks;
+}
+
+void print_blocks(const std::vector<block_summary>& blocks)
+{
+    fmt::print(
+        "  {:>8} {:>10} {:>8} {:>10} {:>12} {:>10}\n",
+        "block",
+        "start",
+        "length",
+        "entries",
+        "executed",
+        "back edges");
+
+    for (const auto& b : blocks) {
+        fmt::print(
+            "  {:>8} {:>10} {:>8} {:>10} {:>12} {:>10}\n",
+            b.block,
+            b.start,
+            b.length,
+            b.entries,
+            b.executed,
+            b.back_edges);
+    }
+}
+
+void print_report(const aoc::day08::console_trace& trace, std::size_t top)
+{
+    auto blocks   = summarize(trace);
+    auto executed = std::accumulate(trace.hits.begin(), trace.hits.end(), uint64_t{0});
+
+    fmt::print(
+        "{} instructions in {} blocks, {} instructions executed over part 1 and {} repair attempts\n",
+        trace.hits.size(),
+        blocks.size(),
+        executed,
+        trace.repair_attempts);
+
+    if (trace.repair < trace.hits.size()) {
+        fmt::print("Flipping instruction {} lets the program finish\n", trace.repair);
+    }
+    else {
+        fmt::print("No single flip lets the program finish\n");
+    }
+
+    fmt::print("\nPart 1 entered {} blocks. ", trace.executed_blocks.size());
+
+    if (trace.looped) {
+        auto closing = std::find_if(blocks.begin(), blocks.end(), [&trace](const auto& block) {
+            return trace.stop >= block.start && trace.stop < block.start + block.length;
+        });
+
+        fmt::print("Stopped before repeating instruction {}", trace.stop);
+        if (closing != blocks.end()) fmt::print(" (loop entry, block {})", closing->block);
+    }
+    else {
+        fmt::print("Ran off the end at instruction {}", trace.stop);
+    }
+    fmt::print(", accumulator {}\n", trace.final_accumulator);
+
+    if (!trace.accumulator.empty()) {
+        auto [low, high] = std::minmax_element(trace.accumulator.begin(), trace.accumulator.end());
+        fmt::print("Accumulator ranged from {} to {} on block entry\n", *low, *high);
+    }
+
+    auto hottest = blocks;
+    std::stable_sort(hottest.begin(), hottest.end(), [](const auto& a, const auto& b) {
+        return a.executed > b.executed;
+    });
+    hottest.resize(std::min(top, hottest.size()));
+
+    fmt::print("\nHottest blocks\n");
+    print_blocks(hottest);
+
+    std::vector<block_summary> loops;
+    std::copy_if(blocks.begin(), blocks.end(), std::back_inserter(loops), [](const auto& b) {
+        return b.back_edges > 0;
+    });
+    std::stable_sort(loops.begin(), loops.end(), [](const auto& a, const auto& b) {
+        return a.back_edges > b.back_edges;
+    });
+    loops.resize(std::min(top, loops.size()));
+
+    fmt::print("\nLoop entry points\n");
+    print_blocks(loops);
+}
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    try {
+        auto opts = parse_options(argc, argv);
+
+        if (!opts.record.empty()) {
+            aoc::day08::save_console_trace(opts.trace, aoc::day08::record_console_trace(opts.record));
+        }
+
+        print_report(aoc::day08::load_console_trace(opts.trace), opts.top);
+    }
+    catch (const std::exception& e) {
+        fmt::print(stderr, "{}\n", e.what());
+        return 1;
+    }
+
+    return 0;
+}
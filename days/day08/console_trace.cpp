@@ -0,0 +1,169 @@
+#include "console_trace.hpp"
+
+#include <fmt/format.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <stdexcept>
+#include <string_view>
+
+namespace aoc::day08 {
+
+namespace {
+
+    constexpr std::string_view trace_tag = "GCT2";
+
+    void put_varint(std::vector<uint8_t>& out, uint64_t value)
+    {
+        while (value >= 0x80) {
+            out.push_back(static_cast<uint8_t>(value | 0x80));
+            value >>= 7;
+        }
+
+        out.push_back(static_cast<uint8_t>(value));
+    }
+
+    void put_signed(std::vector<uint8_t>& out, int64_t value)
+    {
+        put_varint(out, (static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63));
+    }
+
+    class trace_reader {
+    public:
+        explicit trace_reader(const std::vector<uint8_t>& bytes)
+            : bytes_{bytes}
+        {
+        }
+
+        uint64_t varint()
+        {
+            uint64_t value = 0;
+
+            for (int shift = 0; shift < 64; shift += 7) {
+                if (pos_ == bytes_.size()) throw std::runtime_error{"Console trace is truncated"};
+
+                auto byte = bytes_[pos_++];
+                value |= static_cast<uint64_t>(byte & 0x7f) << shift;
+
+                if ((byte & 0x80) == 0) return value;
+            }
+
+            throw std::runtime_error{"Console trace holds an oversized varint"};
+        }
+
+        int64_t signed_varint()
+        {
+            auto value = varint();
+            return static_cast<int64_t>(value >> 1) ^ -static_cast<int64_t>(value & 1);
+        }
+
+        uint32_t count()
+        {
+            auto value = varint();
+
+            // Every counted entry takes at least one byte.
+            if (value > bytes_.size() - pos_) throw std::runtime_error{"Console trace is truncated"};
+
+            return static_cast<uint32_t>(value);
+        }
+
+    private:
+        const std::vector<uint8_t>& bytes_;
+        std::size_t                 pos_ = trace_tag.size();
+    };
+
+} // namespace
+
+void save_console_trace(const std::filesystem::path& path, const console_trace& trace)
+{
+    std::vector<uint8_t> out(trace_tag.begin(), trace_tag.end());
+
+    put_varint(out, trace.hits.size());
+    for (auto hits : trace.hits) {
+        put_varint(out, hits);
+    }
+
+    put_varint(out, trace.block_lengths.size());
+    for (auto length : trace.block_lengths) {
+        put_varint(out, length);
+    }
+
+    put_varint(out, trace.executed_blocks.size());
+
+    int64_t previous = 0;
+    for (std::size_t i = 0; i < trace.executed_blocks.size(); ++i) {
+        put_varint(out, trace.executed_blocks[i]);
+        put_signed(out, trace.accumulator[i] - previous);
+        previous = trace.accumulator[i];
+    }
+
+    put_signed(out, trace.final_accumulator);
+    put_varint(out, trace.stop);
+    out.push_back(trace.looped ? 1 : 0);
+    put_varint(out, trace.repair_attempts);
+    put_varint(out, trace.repair);
+
+    std::FILE* file = std::fopen(path.string().c_str(), "wb");
+
+    if (file == nullptr) throw std::runtime_error{fmt::format("Unable to write {}", path.string())};
+
+    auto written = std::fwrite(out.data(), 1, out.size(), file);
+
+    if (std::fclose(file) != 0 || written != out.size()) {
+        throw std::runtime_error{fmt::format("Unable to write {}", path.string())};
+    }
+}
+
+console_trace load_console_trace(const std::filesystem::path& path)
+{
+    std::ifstream file{path, std::ios::binary};
+
+    if (!file) throw std::runtime_error{fmt::format("Unable to read {}", path.string())};
+
+    std::vector<uint8_t> bytes{std::istreambuf_iterator<char>{file}, std::istreambuf_iterator<char>{}};
+
+    if (bytes.size() < trace_tag.size()
+        || !std::equal(trace_tag.begin(), trace_tag.end(), bytes.begin())) {
+        throw std::runtime_error{fmt::format("{} is not a console trace", path.string())};
+    }
+
+    trace_reader  reader{bytes};
+    console_trace trace;
+
+    trace.hits.resize(reader.count());
+    for (auto& hits : trace.hits) {
+        hits = static_cast<uint32_t>(reader.varint());
+    }
+
+    trace.block_lengths.resize(reader.count());
+    for (auto& length : trace.block_lengths) {
+        length = static_cast<uint32_t>(reader.varint());
+    }
+
+    auto executed = reader.count();
+    trace.executed_blocks.resize(executed);
+    trace.accumulator.resize(executed);
+
+    int64_t accumulator = 0;
+    for (std::size_t i = 0; i < executed; ++i) {
+        trace.executed_blocks[i] = static_cast<uint32_t>(reader.varint());
+        if (trace.executed_blocks[i] >= trace.block_lengths.size()) {
+            throw std::runtime_error{"Console trace refers to an unknown block"};
+        }
+
+        accumulator += reader.signed_varint();
+        trace.accumulator[i] = static_cast<int32_t>(accumulator);
+    }
+
+    trace.final_accumulator = static_cast<int32_t>(reader.signed_varint());
+    trace.stop              = static_cast<uint32_t>(reader.varint());
+    trace.looped            = reader.varint() != 0;
+    trace.repair_attempts   = static_cast<uint32_t>(reader.varint());
+    trace.repair            = static_cast<uint32_t>(reader.varint());
+
+    return trace;
+}
+
+} // namespace aoc::day08
@@ -0,0 +1,41 @@
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <vector>
+
+namespace aoc::day08 {
+
+// Execution profile of the game console over the part 1 run and the brute-force part 2 search,
+// which reruns the program with one nop or jmp flipped at a time until a run reaches the end.
+// hits counts how often each instruction ran over all of those runs; repair_attempts is the number
+// of flipped runs and repair the instruction whose flip finished, or the program size when none did.
+//
+// Basic blocks are those of the unmodified program and partition it in order, so block i starts
+// where block i - 1 ends. The remaining fields describe the part 1 run alone: executed_blocks lists
+// the blocks in the order they were entered and accumulator holds the accumulator on each of those
+// entries. stop is the instruction the run ended on: the first repeated one when looped is set, the
+// program size otherwise.
+struct console_trace {
+    std::vector<uint32_t> hits;
+    std::vector<uint32_t> block_lengths;
+    std::vector<uint32_t> executed_blocks;
+    std::vector<int32_t>  accumulator;
+    int32_t               final_accumulator = 0;
+    uint32_t              stop              = 0;
+    bool                  looped            = false;
+    uint32_t              repair_attempts   = 0;
+    uint32_t              repair            = 0;
+};
+
+// Compact binary form: a "GCT2" tag followed by LEB128 varints, with the accumulator timeline
+// stored as zigzag-encoded deltas. load_console_trace throws std::runtime_error on files that are
+// not traces or are cut short.
+void save_console_trace(const std::filesystem::path& path, const console_trace& trace);
+
+console_trace load_console_trace(const std::filesystem::path& path);
+
+// Reads the program in an input file and profiles it as described above. Defined by day 8.
+console_trace record_console_trace(const std::filesystem::path& input_path);
+
+} // namespace aoc::day08
@@ -1,14 +1,37 @@
+#include "console_trace.hpp"
+
+#include <aoc2020/aoc2020.hpp>
+#include <aoc2020/registry.hpp>
 
-#include <fmt/core.h>
 #include <range/v3/all.hpp>
 
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
 #include <fstream>
+#include <initializer_list>
 #include <map>
-#include <set>
+#include <numeric>
+#include <optional>
+#include <stdexcept>
+#include <system_error>
+#include <utility>
+#include <vector>
 
 namespace rs = ranges;
 namespace rv = ranges::views;
 
+namespace {
+
+#if defined(__x86_64__) || defined(_M_X64)
+constexpr bool jit_supported = true;
+#else
+constexpr bool jit_supported = false;
+#endif
+
+// Runs a program until it would execute an instruction a second time or leaves the program. The
+// program is decoded once into {next, acc_delta} pairs with every jump resolved to its target, which
+// makes nop, acc and jmp the same step; visited instructions are tracked in a dense bitmap.
 class game_console {
 public:
     enum class OP_TYPE : int { NOP = 0, JMP = 1, ACC = 2 };
@@ -25,47 +48,257 @@ public:
         bool inf_loop_reached;
     };
 
+    // The jit backend translates the program to x86-64 and runs it natively. It falls back to the
+    // interpreter on other hosts and when the system won't hand out executable memory.
+    enum class backend { interpreter, jit };
+
 public:
     game_console(const std::vector<instruction>& program)
-        : program_{program}
+        : code_(program.size())
+    {
+        for (std::size_t i = 0; i < program.size(); ++i) {
+            code_[i].next      = static_cast<uint32_t>(next_instruction(program, i, false));
+            code_[i].acc_delta = program[i].op == OP_TYPE::ACC ? program[i].amt : 0;
+        }
+    }
+
+    result run(backend engine = backend::interpreter) const
     {
+        if (engine == backend::jit) {
+            if (auto compiled = run_compiled()) return *compiled;
+        }
+
+        return interpret();
     }
 
-    result run()
+    // Interprets the program like run() while recording the hits of every instruction, the basic
+    // blocks in the order they were entered and the accumulator on each entry. Kept apart from
+    // run() so the unprofiled loop pays nothing for it.
+    result run(aoc::day08::console_trace& trace) const
     {
-        std::set<int> cache;
-
-        while (!inf_loop_detected_) {
-            auto& i = program_[next_instruction_];
-
-            switch (i.op) {
-                case OP_TYPE::NOP: {
-                    ++next_instruction_;
-                } break;
-                case OP_TYPE::JMP: {
-                    next_instruction_ += i.amt;
-                } break;
-                case OP_TYPE::ACC: {
-                    accumulator_ += i.amt;
-                    ++next_instruction_;
-                } break;
+        const auto halt   = static_cast<uint32_t>(code_.size());
+        const auto leader = block_leaders();
+
+        trace = {};
+        trace.hits.assign(halt, 0);
+
+        std::vector<uint32_t> block_of(halt);
+
+        for (uint32_t i = 0; i < halt; ++i) {
+            if (leader[i]) trace.block_lengths.push_back(0);
+
+            block_of[i] = static_cast<uint32_t>(trace.block_lengths.size() - 1);
+            ++trace.block_lengths.back();
+        }
+
+        uint32_t accumulator = 0;
+        uint32_t pc          = 0;
+
+        while (pc != halt && trace.hits[pc] == 0) {
+            if (leader[pc]) {
+                trace.executed_blocks.push_back(block_of[pc]);
+                trace.accumulator.push_back(static_cast<int32_t>(accumulator));
             }
 
-            if (next_instruction_ >= static_cast<int>(program_.size())) break;
+            ++trace.hits[pc];
 
-            inf_loop_detected_ = cache.contains(next_instruction_);
+            accumulator += static_cast<uint32_t>(code_[pc].acc_delta);
+            pc = code_[pc].next;
+        }
 
-            if (!inf_loop_detected_) cache.emplace(next_instruction_);
+        trace.final_accumulator = static_cast<int32_t>(accumulator);
+        trace.stop              = pc;
+        trace.looped            = pc != halt;
+
+        return {trace.final_accumulator, trace.looped};
+    }
+
+    // Interprets the program like run() and adds every instruction it executes to hits, so repeated
+    // runs build up a histogram.
+    result count_hits(std::vector<uint32_t>& hits) const
+    {
+        const auto        halt = static_cast<uint32_t>(code_.size());
+        std::vector<bool> visited(code_.size(), false);
+
+        uint32_t accumulator = 0;
+        uint32_t pc          = 0;
+
+        while (pc != halt && !visited[pc]) {
+            visited[pc] = true;
+            ++hits[pc];
+
+            accumulator += static_cast<uint32_t>(code_[pc].acc_delta);
+            pc = code_[pc].next;
         }
 
-        return {accumulator_, inf_loop_detected_};
+        return {static_cast<int>(accumulator), pc != halt};
+    }
+
+    // Index executed after instruction i of p, with a nop or jmp at i swapped for the other when
+    // flipped is set. Any jump out of the program, including one before the first instruction, ends
+    // it and yields p.size().
+    static std::size_t next_instruction(const program& p, std::size_t i, bool flipped)
+    {
+        auto jumps = (p[i].op == OP_TYPE::JMP) != (flipped && p[i].op != OP_TYPE::ACC);
+        auto next  = static_cast<int64_t>(i) + (jumps ? p[i].amt : 1);
+        auto halt  = static_cast<int64_t>(p.size());
+
+        return static_cast<std::size_t>(next < 0 || next > halt ? halt : next);
     }
 
 private:
-    const program& program_;
-    int            accumulator_       = 0;
-    int            next_instruction_  = 0;
-    bool           inf_loop_detected_ = false;
+    // The accumulator is kept in uint32_t so it wraps on overflow exactly like the jit's add eax.
+    result interpret() const
+    {
+        const auto            halt = static_cast<uint32_t>(code_.size());
+        std::vector<uint64_t> visited((code_.size() + 63) / 64);
+
+        uint32_t accumulator = 0;
+        uint32_t pc          = 0;
+
+        while (pc != halt) {
+            auto& word = visited[pc / 64];
+            auto  bit  = uint64_t{1} << (pc % 64);
+
+            if ((word & bit) != 0) return {static_cast<int>(accumulator), true};
+            word |= bit;
+
+            accumulator += static_cast<uint32_t>(code_[pc].acc_delta);
+            pc = code_[pc].next;
+        }
+
+        return {static_cast<int>(accumulator), false};
+    }
+
+    // Marks the first instruction of every basic block: the entry, every jump target and every
+    // instruction after a jump. Entry [size] stands for the end of the program.
+    std::vector<bool> block_leaders() const
+    {
+        std::vector<bool> leader(code_.size() + 1, false);
+        leader[0] = true;
+
+        for (std::size_t i = 0; i < code_.size(); ++i) {
+            if (code_[i].next == i + 1) continue;
+
+            leader[code_[i].next] = true;
+            leader[i + 1]         = true;
+        }
+
+        return leader;
+    }
+
+    // Native code for the program: one visit flag per basic block, checked and set on entry, which
+    // catches the same first repeat as per-instruction flags since jumps only land on block starts.
+    // acc becomes add eax, imm32 and jmp a jmp rel32 between blocks. The function takes the flags
+    // and returns the accumulator in the low half of rax, with bit 32 set when a loop was found.
+    std::vector<uint8_t> translate(uint32_t& blocks) const
+    {
+        const auto halt   = code_.size();
+        const auto leader = block_leaders();
+
+        std::vector<uint8_t> out;
+
+        auto emit = [&out](std::initializer_list<uint8_t> bytes) { out.insert(out.end(), bytes); };
+        auto emit32 = [&out](uint32_t value) {
+            for (int shift = 0; shift < 32; shift += 8) {
+                out.push_back(static_cast<uint8_t>(value >> shift));
+            }
+        };
+
+        std::vector<std::size_t>                         labels(halt + 1, 0);
+        std::vector<std::pair<std::size_t, std::size_t>> jumps;
+        std::vector<std::size_t>                         loop_exits;
+
+#ifdef _WIN32
+        emit({0x48, 0x89, 0xCA}); // mov rdx, rcx
+#else
+        emit({0x48, 0x89, 0xFA}); // mov rdx, rdi
+#endif
+        emit({0x31, 0xC0}); // xor eax, eax
+
+        blocks = 0;
+
+        for (std::size_t i = 0; i < halt; ++i) {
+            if (leader[i]) {
+                labels[i] = out.size();
+
+                emit({0x80, 0xBA}); // cmp byte [rdx + block], 0
+                emit32(blocks);
+                emit({0x00});
+                emit({0x0F, 0x85}); // jne looped
+                loop_exits.push_back(out.size());
+                emit32(0);
+                emit({0xC6, 0x82}); // mov byte [rdx + block], 1
+                emit32(blocks);
+                emit({0x01});
+
+                ++blocks;
+            }
+
+            if (code_[i].acc_delta != 0) {
+                emit({0x05}); // add eax, imm32
+                emit32(static_cast<uint32_t>(code_[i].acc_delta));
+            }
+
+            if (code_[i].next != i + 1) {
+                emit({0xE9}); // jmp rel32
+                jumps.emplace_back(out.size(), code_[i].next);
+                emit32(0);
+            }
+        }
+
+        labels[halt] = out.size();
+        emit({0xC3}); // ret
+
+        auto looped = out.size();
+        emit({0x48, 0x0F, 0xBA, 0xE8, 0x20}); // bts rax, 32
+        emit({0xC3});                         // ret
+
+        auto patch = [&out](std::size_t at, std::size_t target) {
+            auto rel = static_cast<int64_t>(target) - static_cast<int64_t>(at + 4);
+            for (std::size_t k = 0; k < 4; ++k) {
+                out[at + k] = static_cast<uint8_t>(static_cast<uint64_t>(rel) >> (8 * k));
+            }
+        };
+
+        for (auto [at, target] : jumps) {
+            patch(at, labels[target]);
+        }
+
+        for (auto at : loop_exits) {
+            patch(at, looped);
+        }
+
+        return out;
+    }
+
+    std::optional<result> run_compiled() const
+    {
+        if constexpr (!jit_supported) return std::nullopt;
+
+        uint32_t blocks = 0;
+        auto     native = translate(blocks);
+
+        try {
+            aoc::executable_code code{native};
+            std::vector<uint8_t> visited(blocks, 0);
+
+            using entry_point = uint64_t (*)(uint8_t*);
+            auto value = reinterpret_cast<entry_point>(const_cast<void*>(code.entry()))(visited.data());
+
+            return result{static_cast<int>(static_cast<uint32_t>(value)), (value >> 32) != 0};
+        }
+        catch (const std::system_error&) {
+            return std::nullopt;
+        }
+    }
+
+    struct decoded_instruction {
+        uint32_t next;
+        int32_t  acc_delta;
+    };
+
+    std::vector<decoded_instruction> code_;
 };
 
 game_console::program read_input_program(std::istream&& i)
@@ -86,62 +319,125 @@ game_console::program read_input_program(std::istream&& i)
 
 int part1(const game_console::program& p)
 {
-    game_console console{p};
-
-    auto [acc, _] = console.run();
+    auto [acc, _] = game_console{p}.run();
 
     return acc;
 }
 
-int part2(game_console::program p)
+// Index of the nop or jmp whose flip lets the program run to its end, found in linear time. Walking
+// the control flow backwards from the end marks every instruction that already leads there; the
+// flip is then the first instruction on the execution path whose flipped successor is marked.
+std::optional<std::size_t> find_repair(const game_console::program& p)
 {
-    bool found       = false;
-    int  accumulator = 0, check = 0;
+    const auto halt = p.size();
+
+    std::vector<uint32_t> offsets(halt + 2, 0);
+    std::vector<uint32_t> predecessors(halt);
 
-    while (!found) {
-        while (p[check].op != game_console::OP_TYPE::NOP && p[check].op != game_console::OP_TYPE::JMP)
-            ++check;
+    for (std::size_t i = 0; i < halt; ++i) {
+        ++offsets[game_console::next_instruction(p, i, false) + 1];
+    }
 
-        // toggle check
-        p[check].op = (p[check].op == game_console::OP_TYPE::NOP) ? game_console::OP_TYPE::JMP
-                                                                  : game_console::OP_TYPE::NOP;
+    std::partial_sum(offsets.begin(), offsets.end(), offsets.begin());
 
-        game_console console{p};
+    std::vector<uint32_t> next_slot(offsets.begin(), offsets.end() - 1);
+
+    for (std::size_t i = 0; i < halt; ++i) {
+        auto next = game_console::next_instruction(p, i, false);
+        predecessors[next_slot[next]++] = static_cast<uint32_t>(i);
+    }
 
-        auto [acc, inf_loop] = console.run();
+    std::vector<bool>        reaches_end(halt + 1, false);
+    std::vector<std::size_t> pending{halt};
 
-        if (!inf_loop) {
-            found       = true;
-            accumulator = acc;
+    reaches_end[halt] = true;
+
+    while (!pending.empty()) {
+        auto i = pending.back();
+        pending.pop_back();
+
+        for (auto k = offsets[i]; k < offsets[i + 1]; ++k) {
+            reaches_end[predecessors[k]] = true;
+            pending.push_back(predecessors[k]);
         }
+    }
+
+    std::vector<bool> visited(halt, false);
 
-        // toggle back
-        p[check].op = (p[check].op == game_console::OP_TYPE::NOP) ? game_console::OP_TYPE::JMP
-                                                                  : game_console::OP_TYPE::NOP;
+    for (std::size_t pc = 0; pc != halt && !visited[pc];) {
+        visited[pc] = true;
 
-        ++check;
+        if (p[pc].op != game_console::OP_TYPE::ACC
+            && reaches_end[game_console::next_instruction(p, pc, true)]) {
+            return pc;
+        }
+
+        pc = game_console::next_instruction(p, pc, false);
     }
 
-    return accumulator;
+    return std::nullopt;
+}
+
+int part2(const game_console::program& p)
+{
+    auto repair = find_repair(p);
+
+    if (!repair) throw std::runtime_error{"No single nop/jmp flip lets the program terminate"};
+
+    auto patched = p;
+    auto& op     = patched[*repair].op;
+
+    op = op == game_console::OP_TYPE::NOP ? game_console::OP_TYPE::JMP : game_console::OP_TYPE::NOP;
+
+    return game_console{patched}.run().acc_state;
 }
 
-#ifndef UNIT_TESTING
+const aoc::day_registrar registrar{
+    8,
+    [](const auto& input_path) { return read_input_program(std::ifstream{input_path}); },
+    part1,
+    part2};
 
-int main()
+// The part 1 run followed by the brute-force repair search that find_repair avoids: every nop or
+// jmp flipped in turn, in program order, until a run reaches the end.
+aoc::day08::console_trace profile_repairs(const game_console::program& p)
 {
-    fmt::print("Advent of Code 2020 - Day 08\n");
+    using op = game_console::OP_TYPE;
+
+    aoc::day08::console_trace trace;
+    game_console{p}.run(trace);
 
-    auto program = read_input_program(std::ifstream{"days/day08/puzzle.in"});
+    trace.repair = static_cast<uint32_t>(p.size());
 
-    fmt::print("Part 1 Solution: {}\n", part1(program));
-    fmt::print("Part 2 Solution: {}\n", part2(std::move(program)));
+    for (std::size_t i = 0; i < p.size(); ++i) {
+        if (p[i].op == op::ACC) continue;
 
-    return 0;
+        auto patched  = p;
+        patched[i].op = patched[i].op == op::NOP ? op::JMP : op::NOP;
+
+        ++trace.repair_attempts;
+
+        if (!game_console{patched}.count_hits(trace.hits).inf_loop_reached) {
+            trace.repair = static_cast<uint32_t>(i);
+            break;
+        }
+    }
+
+    return trace;
 }
 
-#else
+} // namespace
+
+aoc::day08::console_trace aoc::day08::record_console_trace(const std::filesystem::path& input_path)
+{
+    return profile_repairs(read_input_program(std::ifstream{input_path}));
+}
+
+#ifdef UNIT_TESTING
 
 #define CATCH_CONFIG_MAIN
+#include <aoc2020/generators.hpp>
+
 #include <catch2/catch.hpp>
 #include <sstream>
 
@@ -169,6 +465,140 @@ acc +6)";
     SECTION("Can solve part 1 example") { REQUIRE(5 == part1(program)); }
 
     SECTION("Can solve part 2 example") { REQUIRE(8 == part2(program)); }
+
+    SECTION("Stops on the first repeated instruction or when leaving the program")
+    {
+        using op = game_console::OP_TYPE;
+
+        auto self_loop = game_console::program{{op::ACC, 2}, {op::JMP, 0}};
+        REQUIRE(2 == game_console{self_loop}.run().acc_state);
+        REQUIRE(game_console{self_loop}.run().inf_loop_reached);
+
+        auto backwards = game_console::program{{op::ACC, 3}, {op::JMP, -5}, {op::ACC, 9}};
+        REQUIRE(3 == game_console{backwards}.run().acc_state);
+        REQUIRE_FALSE(game_console{backwards}.run().inf_loop_reached);
+
+        REQUIRE_FALSE(game_console{game_console::program{}}.run().inf_loop_reached);
+    }
+
+    SECTION("Finds the flip on the execution path")
+    {
+        REQUIRE(7 == find_repair(program));
+
+        using op = game_console::OP_TYPE;
+
+        // The jmp at 3 already leads to the end, but it is never executed.
+        auto skipped = game_console::program{
+            {op::ACC, 1}, {op::NOP, 3}, {op::JMP, -2}, {op::JMP, 100}, {op::ACC, 10}};
+
+        REQUIRE(1 == find_repair(skipped));
+        REQUIRE(11 == part2(skipped));
+        REQUIRE_FALSE(find_repair(game_console::program{{op::JMP, 0}, {op::JMP, -1}}).has_value());
+        REQUIRE_THROWS(part2(game_console::program{{op::JMP, 0}, {op::JMP, -1}}));
+    }
+
+    SECTION("The jit backend matches the interpreter")
+    {
+        using op = game_console::OP_TYPE;
+
+        auto jit = game_console::backend::jit;
+
+        for (const auto& p : {
+                 program,
+                 game_console::program{},
+                 game_console::program{{op::JMP, 0}},
+                 game_console::program{{op::ACC, -7}, {op::JMP, 1}, {op::ACC, 3}},
+                 game_console::program{{op::ACC, 3}, {op::JMP, -5}, {op::ACC, 9}},
+                 game_console::program{{op::ACC, 1}, {op::NOP, 0}, {op::ACC, -2}, {op::JMP, -2}},
+                 game_console::program{{op::ACC, INT32_MAX}, {op::ACC, 1}},
+                 game_console::program{{op::ACC, INT32_MIN}, {op::ACC, -1}, {op::JMP, -1}}}) {
+            auto expected = game_console{p}.run();
+            auto actual   = game_console{p}.run(jit);
+
+            REQUIRE(expected.acc_state == actual.acc_state);
+            REQUIRE(expected.inf_loop_reached == actual.inf_loop_reached);
+        }
+
+        REQUIRE(INT32_MIN == game_console{{{op::ACC, INT32_MAX}, {op::ACC, 1}}}.run().acc_state);
+
+        const auto* generator = aoc::find_generator(8);
+        REQUIRE(generator != nullptr);
+
+        for (uint64_t seed = 1; seed <= 20; ++seed) {
+            fmt::memory_buffer buffer;
+            generator->generate(buffer, 1000 * static_cast<int64_t>(seed), seed);
+
+            auto generated = read_input_program(std::stringstream{fmt::to_string(buffer)});
+            auto looping   = game_console{generated}.run(jit);
+
+            REQUIRE(looping.inf_loop_reached);
+            REQUIRE(game_console{generated}.run().acc_state == looping.acc_state);
+
+            auto repaired = generated;
+            auto& flipped = repaired[find_repair(generated).value()].op;
+            flipped       = flipped == op::NOP ? op::JMP : op::NOP;
+
+            auto finished = game_console{repaired}.run(jit);
+
+            REQUIRE_FALSE(finished.inf_loop_reached);
+            REQUIRE(game_console{repaired}.run().acc_state == finished.acc_state);
+        }
+    }
+
+    SECTION("Profiles a run into a trace")
+    {
+        aoc::day08::console_trace trace;
+        auto                      profiled = game_console{program}.run(trace);
+
+        REQUIRE(5 == profiled.acc_state);
+        REQUIRE(profiled.inf_loop_reached);
+
+        // Blocks start at 0, 1, 3, 5, 6 and 8; the run enters 0, 1, 6 and 3, then repeats 1.
+        REQUIRE(std::vector<uint32_t>{1, 1, 1, 1, 1, 0, 1, 1, 0} == trace.hits);
+        REQUIRE(std::vector<uint32_t>{1, 2, 2, 1, 2, 1} == trace.block_lengths);
+        REQUIRE(std::vector<uint32_t>{0, 1, 4, 2} == trace.executed_blocks);
+        REQUIRE(std::vector<int32_t>{0, 0, 1, 2} == trace.accumulator);
+        REQUIRE(1 == trace.stop);
+        REQUIRE(trace.looped);
+    }
+
+    SECTION("Profiles the brute-force repair search")
+    {
+        auto trace = profile_repairs(program);
+
+        // Flipping 0, 2 and 4 still loops; flipping the jmp at 7 reaches the end. Every run adds
+        // to the hits of the part 1 run, while the block timeline stays that of part 1.
+        REQUIRE(std::vector<uint32_t>{5, 4, 4, 3, 3, 1, 3, 3, 1} == trace.hits);
+        REQUIRE(std::vector<uint32_t>{0, 1, 4, 2} == trace.executed_blocks);
+        REQUIRE(4 == trace.repair_attempts);
+        REQUIRE(7 == trace.repair);
+
+        auto path = std::filesystem::temp_directory_path() / "aoc2020_day08_test.trace";
+        aoc::day08::save_console_trace(path, trace);
+        auto loaded = aoc::day08::load_console_trace(path);
+        std::filesystem::remove(path);
+
+        REQUIRE(trace.hits == loaded.hits);
+        REQUIRE(trace.block_lengths == loaded.block_lengths);
+        REQUIRE(trace.executed_blocks == loaded.executed_blocks);
+        REQUIRE(trace.accumulator == loaded.accumulator);
+        REQUIRE(trace.final_accumulator == loaded.final_accumulator);
+        REQUIRE(trace.stop == loaded.stop);
+        REQUIRE(trace.looped == loaded.looped);
+        REQUIRE(trace.repair_attempts == loaded.repair_attempts);
+        REQUIRE(trace.repair == loaded.repair);
+    }
+
+    SECTION("Runs long programs")
+    {
+        using op = game_console::OP_TYPE;
+
+        game_console::program chain(100000, {op::ACC, 1});
+        chain.push_back({op::JMP, -100000});
+
+        REQUIRE(100000 == part1(chain));
+        REQUIRE(100000 == part2(chain));
+    }
 }
 
 #endif
@@ -1,22 +1,15 @@
+#include <aoc2020/aoc2020.hpp>
+#include <aoc2020/registry.hpp>
 
-#include <fmt/core.h>
 #include <range/v3/all.hpp>
 
 #include <cstdint>
-#include <fstream>
 #include <optional>
 
 namespace rs = ranges;
 namespace rv = ranges::views;
 
-std::vector<int64_t> read_input(std::istream&& i)
-{
-    // clang-format off
-    return rs::getlines(i) 
-        | rv::transform([](auto&& s) ->int64_t { return std::stoll(s); })
-        | rs::to<std::vector>;
-    // clang-format on
-}
+namespace {
 
 int64_t part1(const std::vector<int64_t>& input, int window_size)
 {
@@ -58,23 +51,17 @@ int64_t part2(const std::vector<int64_t>& input, int64_t target)
     return result.value();
 }
 
-#ifndef UNIT_TESTING
-
-int main()
-{
-    fmt::print("Advent of Code 2020 - Day 09\n");
-
-    auto input = read_input(std::ifstream{"days/day09/puzzle.in"});
-
-    int window_size = 25;
+const aoc::day_registrar registrar{
+    9,
+    [](const auto& input_path) {
+        return aoc::read_int64_per_line(aoc::mapped_input{input_path}.view());
+    },
+    [](const auto& input) { return part1(input, 25); },
+    [](const auto& input) { return part2(input, part1(input, 25)); }};
 
-    fmt::print("Part 1 Solution: {}\n", part1(input, window_size));
-    fmt::print("Part 2 Solution: {}\n", part2(input, part1(input, window_size)));
-
-    return 0;
-}
+} // namespace
 
-#else
+#ifdef UNIT_TESTING
 
 #define CATCH_CONFIG_MAIN
 #include <catch2/catch.hpp>
@@ -105,7 +92,7 @@ TEST_CASE("Can solve day 9 problems")
 309
 576)";
 
-    auto input       = read_input(std::move(ss));
+    auto input       = aoc::read_int64_per_line(std::move(ss));
     auto window_size = 5;
 
     REQUIRE(20 == input.size());
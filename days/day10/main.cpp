@@ -1,14 +1,14 @@
 #include <aoc2020/aoc2020.hpp>
+#include <aoc2020/registry.hpp>
 
-#include <fmt/core.h>
 #include <range/v3/all.hpp>
 
-#include <fstream>
-
 namespace rs = ranges;
 namespace ra = ranges::actions;
 namespace rv = ranges::views;
 
+namespace {
+
 int64_t combinations(int64_t d)
 {
     // TODO solve for the general case
@@ -50,21 +50,17 @@ int64_t part2(const std::vector<int>& input)
     // clang-format on
 }
 
-#ifndef UNIT_TESTING
-
-int main()
-{
-    fmt::print("Advent of Code 2020 - Day 10\n");
+const aoc::day_registrar registrar{
+    10,
+    [](const auto& input_path) {
+        return aoc::read_int_per_line(aoc::mapped_input{input_path}.view()) | ra::sort;
+    },
+    part1,
+    part2};
 
-    auto input = aoc::read_int_per_line(std::ifstream{"days/day10/puzzle.in"}) | ra::sort;
-
-    fmt::print("Part 1 Solution: {}\n", part1(input));
-    fmt::print("Part 2 Solution: {}\n", part2(input));
-
-    return 0;
-}
+} // namespace
 
-#else
+#ifdef UNIT_TESTING
 
 #define CATCH_CONFIG_MAIN
 #include <catch2/catch.hpp>
@@ -1,4 +1,5 @@
-#include <fmt/core.h>
+#include <aoc2020/registry.hpp>
+
 #include <range/v3/all.hpp>
 
 #include <fstream>
@@ -8,6 +9,8 @@ namespace rs = ranges;
 namespace ra = ranges::actions;
 namespace rv = ranges::views;
 
+namespace {
+
 enum class direction {
     TOP_LEFT = 0,
     TOP_MIDDLE,
@@ -187,21 +190,15 @@ int64_t part2(std::vector<char> input, int64_t stride)
     return current_counter;
 }
 
-#ifndef UNIT_TESTING
-
-int main()
-{
-    fmt::print("Advent of Code 2020 - Day 11\n");
+const aoc::day_registrar registrar{
+    11,
+    [](const auto& input_path) { return read_input(std::ifstream{input_path}); },
+    [](const auto& input) { return part1(input.first, input.second); },
+    [](const auto& input) { return part2(input.first, input.second); }};
 
-    auto [input, stride] = read_input(std::ifstream{"days/day11/puzzle.in"});
-
-    fmt::print("Part 1 Solution: {}\n", part1(input, stride));
-    fmt::print("Part 2 Solution: {}\n", part2(input, stride));
-
-    return 0;
-}
+} // namespace
 
-#else
+#ifdef UNIT_TESTING
 
 #define CATCH_CONFIG_MAIN
 #include <catch2/catch.hpp>
@@ -1,4 +1,5 @@
-#include <fmt/core.h>
+#include <aoc2020/registry.hpp>
+
 #include <glm/vec2.hpp>
 #include <range/v3/all.hpp>
 
@@ -10,6 +11,8 @@
 namespace rs = ranges;
 namespace rv = ranges::views;
 
+namespace {
+
 struct instruction {
     char dir;
     int  amount;
@@ -53,21 +56,15 @@ int navigate(const std::vector<instruction>& input, glm::ivec2 heading, bool fol
     return std::abs(ship_position.x) + std::abs(ship_position.y);
 }
 
-#ifndef UNIT_TESTING
-
-int main()
-{
-    fmt::print("Advent of Code 2020 - Day 12\n");
+const aoc::day_registrar registrar{
+    12,
+    [](const auto& input_path) { return read_input(std::ifstream{input_path}); },
+    [](const auto& input) { return navigate(input, directions.at('E')); },
+    [](const auto& input) { return navigate(input, {10, 1}, true); }};
 
-    auto input = read_input(std::ifstream{"days/day12/puzzle.in"});
-
-    fmt::print("Part 1 Solution: {}\n", navigate(input, directions.at('E')));
-    fmt::print("Part 2 Solution: {}\n", navigate(input, {10, 1}, true));
-
-    return 0;
-}
+} // namespace
 
-#else
+#ifdef UNIT_TESTING
 
 #define CATCH_CONFIG_MAIN
 #include <catch2/catch.hpp>
@@ -1,4 +1,5 @@
-#include <fmt/core.h>
+#include <aoc2020/registry.hpp>
+
 #include <range/v3/all.hpp>
 
 #include <fstream>
@@ -6,6 +7,8 @@
 namespace rs = ranges;
 namespace rv = ranges::views;
 
+namespace {
+
 std::pair<int, std::vector<int>> read_input(std::istream&& input)
 {
     std::string tmp;
@@ -58,21 +61,15 @@ int64_t part2(const std::vector<int>& schedules)
     return timestamp;
 }
 
-#ifndef UNIT_TESTING
-
-int main()
-{
-    fmt::print("Advent of Code 2020 - Day 13\n");
+const aoc::day_registrar registrar{
+    13,
+    [](const auto& input_path) { return read_input(std::ifstream{input_path}); },
+    [](const auto& input) { return part1(input.first, input.second); },
+    [](const auto& input) { return part2(input.second); }};
 
-    auto [earliest_departure, schedules] = read_input(std::ifstream{"days/day13/puzzle.in"});
-
-    fmt::print("Part 1 Solution: {}\n", part1(earliest_departure, schedules));
-    fmt::print("Part 2 Solution: {}\n", part2(schedules));
-
-    return 0;
-}
+} // namespace
 
-#else
+#ifdef UNIT_TESTING
 
 #define CATCH_CONFIG_MAIN
 #include <catch2/catch.hpp>
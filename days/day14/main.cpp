@@ -1,14 +1,18 @@
-#include <fmt/core.h>
+#include <aoc2020/aoc2020.hpp>
+#include <aoc2020/registry.hpp>
+
 #include <range/v3/all.hpp>
 
 #include <bitset>
-#include <fstream>
 #include <map>
 #include <regex>
+#include <sstream>
 
 namespace rs = ranges;
 namespace rv = ranges::views;
 
+namespace {
+
 std::string parse_to_bits(const std::string& s)
 {
     return std::bitset<36>{static_cast<uint64_t>(std::stoll(s))}.to_string();
@@ -108,21 +112,15 @@ int64_t part2(std::istream&& input)
     return rs::accumulate(nums | rv::values, int64_t{0});
 }
 
-#ifndef UNIT_TESTING
-
-int main()
-{
-    fmt::print("Advent of Code 2020 - Day 14\n");
-
-    std::string input_path = "days/day14/puzzle.in";
+const aoc::day_registrar registrar{
+    14,
+    [](const auto& input_path) { return std::string{aoc::mapped_input{input_path}.view()}; },
+    [](const std::string& input) { return part1(std::istringstream{input}); },
+    [](const std::string& input) { return part2(std::istringstream{input}); }};
 
-    fmt::print("Part 1 Solution: {}\n", part1(std::ifstream{input_path}));
-    fmt::print("Part 2 Solution: {}\n", part2(std::ifstream{input_path}));
-
-    return 0;
-}
+} // namespace
 
-#else
+#ifdef UNIT_TESTING
 
 #define CATCH_CONFIG_MAIN
 #include <catch2/catch.hpp>
@@ -1,14 +1,27 @@
-#include <fmt/core.h>
+#include <aoc2020/registry.hpp>
+
 #include <range/v3/all.hpp>
 
 #include <cstdint>
 #include <fstream>
+#include <string>
 #include <unordered_map>
 #include <vector>
 
 namespace rs = ranges;
 namespace rv = ranges::views;
 
+namespace {
+
+std::vector<int> read_input(std::istream&& input)
+{
+    std::string tmp;
+    std::getline(input, tmp);
+
+    return tmp | rv::split(',')
+           | rv::transform([](auto&& s) { return std::stoi(s | rs::to<std::string>); }) | rs::to_vector;
+}
+
 int solve(const std::vector<int>& input, int nth_number)
 {
     // clang-format off
@@ -35,21 +48,15 @@ int solve(const std::vector<int>& input, int nth_number)
     return last_number;
 }
 
-#ifndef UNIT_TESTING
+const aoc::day_registrar registrar{
+    15,
+    [](const auto& input_path) { return read_input(std::ifstream{input_path}); },
+    [](const auto& input) { return solve(input, 2020); },
+    [](const auto& input) { return solve(input, 30000000); }};
 
-int main()
-{
-    fmt::print("Advent of Code 2020 - Day 15\n");
-
-    std::vector<int> input = {1, 0, 18, 10, 19, 6};
-
-    fmt::print("Part 1 Solution: {}\n", solve(input, 2020));
-    fmt::print("Part 2 Solution: {}\n", solve(input, 30000000));
-
-    return 0;
-}
+} // namespace
 
-#else
+#ifdef UNIT_TESTING
 
 #define CATCH_CONFIG_MAIN
 #include <catch2/catch.hpp>
@@ -1,4 +1,4 @@
-#include <fmt/format.h>
+#include <aoc2020/registry.hpp>
 
 #ifdef _MSC_VER
 #pragma warning(push)
@@ -16,6 +16,8 @@
 namespace rs = ranges;
 namespace rv = ranges::views;
 
+namespace {
+
 struct rule {
     std::string                        name;
     std::array<std::pair<int, int>, 2> valid_ranges;
@@ -142,23 +144,15 @@ int64_t part2(const document& input, const std::string& search_field)
 }
 
 
-#ifndef UNIT_TESTING
-
-int main()
-{
-    fmt::print("Advent of Code 2020 - Day 16\n");
-
-    std::string input_path = "days/day16/puzzle.in";
+const aoc::day_registrar registrar{
+    16,
+    [](const auto& input_path) { return read_input(std::ifstream{input_path}); },
+    part1,
+    [](const auto& input) { return part2(input, "departure"); }};
 
-    auto input = read_input(std::ifstream{input_path});
-
-    fmt::print("Part 1 Solution: {}\n", part1(input));
-    fmt::print("Part 2 Solution: {}\n", part2(input, "departure"));
-
-    return 0;
-}
+} // namespace
 
-#else
+#ifdef UNIT_TESTING
 
 #define CATCH_CONFIG_MAIN
 #include <catch2/catch.hpp>
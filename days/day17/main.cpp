@@ -1,4 +1,6 @@
-#include <fmt/format.h>
+#include <aoc2020/registry.hpp>
+#include <aoc2020/trace.hpp>
+
 #define GLM_ENABLE_EXPERIMENTAL
 #include "glm/gtx/hash.hpp"
 #include <glm/vec3.hpp>
@@ -10,6 +12,8 @@
 namespace rs = ranges;
 namespace rv = ranges::views;
 
+namespace {
+
 template <typename T>
 using grid_t = std::unordered_map<T, bool>;
 
@@ -84,6 +88,9 @@ int count_active_neighbors(grid_t<T>& grid, T p)
 template <typename T>
 void run_cycle(T& grid)
 {
+    AOC_TRACE_SCOPE("day17/run_cycle");
+    AOC_TRACE_COUNT("day17/cells_visited", grid.size());
+
     auto tmp = grid;
 
     for (auto& p : grid) {
@@ -107,21 +114,19 @@ int64_t solve(grid_t<T> grid)
     return rs::count(grid | rv::values, true);
 }
 
-#ifndef UNIT_TESTING
-
-int main()
-{
-    fmt::print("Advent of Code 2020 - Day 17\n");
-
-    std::string input_path = "days/day17/puzzle.in";
+const aoc::day_registrar registrar{
+    17,
+    [](const auto& input_path) {
+        return std::make_pair(
+            read_input_grid<glm::ivec3>(std::ifstream{input_path}),
+            read_input_grid<glm::ivec4>(std::ifstream{input_path}));
+    },
+    [](const auto& input) { return solve(input.first); },
+    [](const auto& input) { return solve(input.second); }};
 
-    fmt::print("Part 1 Solution: {}\n", solve(read_input_grid<glm::ivec3>(std::ifstream{input_path})));
-    fmt::print("Part 2 Solution: {}\n", solve(read_input_grid<glm::ivec4>(std::ifstream{input_path})));
-
-    return 0;
-}
+} // namespace
 
-#else
+#ifdef UNIT_TESTING
 
 #define CATCH_CONFIG_MAIN
 #include <catch2/catch.hpp>
@@ -1,13 +1,16 @@
-#include <fmt/format.h>
+#include <aoc2020/aoc2020.hpp>
+#include <aoc2020/registry.hpp>
+
 #include <range/v3/all.hpp>
 
-#include <fstream>
 #include <sstream>
 #include <string>
 
 namespace rs = ranges;
 namespace rv = ranges::views;
 
+namespace {
+
 int64_t solve_expression(std::istream& expr)
 {
     int64_t solution = 0;
@@ -121,21 +124,15 @@ int64_t part2(std::istream&& input)
     return rs::accumulate(solutions, int64_t{0});
 }
 
-#ifndef UNIT_TESTING
-
-int main()
-{
-    fmt::print("Advent of Code 2020 - Day 18\n");
+const aoc::day_registrar registrar{
+    18,
+    [](const auto& input_path) { return std::string{aoc::mapped_input{input_path}.view()}; },
+    [](const std::string& input) { return part1(std::istringstream{input}); },
+    [](const std::string& input) { return part2(std::istringstream{input}); }};
 
-    std::string input_path = "days/day18/puzzle.in";
-
-    fmt::print("Part 1 Solution: {}\n", part1(std::ifstream{input_path}));
-    fmt::print("Part 2 Solution: {}\n", part2(std::ifstream{input_path}));
-
-    return 0;
-}
+} // namespace
 
-#else
+#ifdef UNIT_TESTING
 
 #define CATCH_CONFIG_MAIN
 #include <catch2/catch.hpp>
@@ -1,4 +1,5 @@
-#include <fmt/format.h>
+#include <aoc2020/registry.hpp>
+
 #include <range/v3/all.hpp>
 
 #include <cctype>
@@ -11,6 +12,8 @@
 namespace rs = ranges;
 namespace rv = ranges::views;
 
+namespace {
+
 struct rule {
     enum class TYPE { MATCH, SUBRULE };
     TYPE                          type;
@@ -108,23 +111,15 @@ int64_t part2(std::unordered_map<int, rule> rules, const std::vector<std::string
         messages | rv::filter([&rules](const auto& s) { return match(rules, rules.at(0), s); }));
 }
 
-#ifndef UNIT_TESTING
-
-int main()
-{
-    fmt::print("Advent of Code 2020 - Day 19\n");
-
-    std::string input_path = "days/day19/puzzle.in";
-
-    auto [rules, messages] = read_input(std::ifstream{input_path});
+const aoc::day_registrar registrar{
+    19,
+    [](const auto& input_path) { return read_input(std::ifstream{input_path}); },
+    [](const auto& input) { return part1(input.first, input.second); },
+    [](const auto& input) { return part2(input.first, input.second); }};
 
-    fmt::print("Part 1 Solution: {}\n", part1(rules, messages));
-    fmt::print("Part 2 Solution: {}\n", part2(rules, messages));
-
-    return 0;
-}
+} // namespace
 
-#else
+#ifdef UNIT_TESTING
 
 #define CATCH_CONFIG_MAIN
 #include <catch2/catch.hpp>
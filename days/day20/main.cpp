@@ -1,6 +1,9 @@
-#include <fmt/format.h>
+#include <aoc2020/registry.hpp>
+#include <aoc2020/trace.hpp>
+
 #include <range/v3/all.hpp>
 
+#include <cmath>
 #include <fstream>
 
 #include <iostream>
@@ -11,6 +14,8 @@
 namespace rs = ranges;
 namespace rv = ranges::views;
 
+namespace {
+
 struct tile {
     int64_t                        id;
     std::vector<std::vector<char>> image_data;
@@ -27,6 +32,8 @@ int parse_tile_id(const std::string& s)
 
 std::vector<tile> read_input(std::istream&& input)
 {
+    AOC_TRACE_SCOPE("day20/read_input");
+
     return rs::getlines(input) | rv::split("") | rv::transform([](auto&& rng) {
                auto v = rng | rv::transform([](auto&& s) { return s | rs::to<std::string>; })
                         | rs::to_vector;
@@ -112,6 +119,8 @@ std::vector<tile> find_neighbors(std::vector<tile> tiles, const tile& t)
 
 auto build_neighbor_map(const std::vector<tile>& tiles)
 {
+    AOC_TRACE_SCOPE("day20/build_neighbor_map");
+
     return tiles
            | rv::transform([&tiles](auto&& t) { return std::make_pair(t, find_neighbors(tiles, t)); })
            | rs::to<std::map<tile, std::vector<tile>, tile_compare>>;
@@ -345,25 +354,20 @@ int64_t part2(std::map<tile, std::vector<tile>, tile_compare> neighbor_map, int
     return water_roughness - (monsters_found * tiles_per_monster);
 }
 
-#ifndef UNIT_TESTING
-
-int main()
-{
-    fmt::print("Advent of Code 2020 - Day 20\n");
-
-    std::string input_path = "days/day20/puzzle.in";
+const aoc::day_registrar registrar{
+    20,
+    [](const auto& input_path) {
+        auto neighbor_map = build_neighbor_map(read_input(std::ifstream{input_path}));
+        auto width        = static_cast<int>(std::sqrt(neighbor_map.size()));
 
-    auto input        = read_input(std::ifstream{input_path});
-    auto neighbor_map = build_neighbor_map(input);
-    auto width        = static_cast<int>(std::sqrt(neighbor_map.size()));
+        return std::make_pair(std::move(neighbor_map), width);
+    },
+    [](const auto& input) { return part1(input.first); },
+    [](const auto& input) { return part2(input.first, input.second); }};
 
-    fmt::print("Part 1 Solution: {}\n", part1(neighbor_map));
-    fmt::print("Part 2 Solution: {}\n", part2(neighbor_map, width));
-
-    return 0;
-}
+} // namespace
 
-#else
+#ifdef UNIT_TESTING
 
 #define CATCH_CONFIG_MAIN
 #include <catch2/catch.hpp>
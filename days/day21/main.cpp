@@ -1,4 +1,5 @@
-#include <fmt/format.h>
+#include <aoc2020/registry.hpp>
+
 #include <range/v3/all.hpp>
 
 #include <fstream>
@@ -12,6 +13,8 @@ namespace rs = ranges;
 namespace ra = ranges::actions;
 namespace rv = ranges::views;
 
+namespace {
+
 struct food {
     std::vector<std::string> ingredients;
     std::vector<std::string> allergens;
@@ -114,23 +117,15 @@ std::string part2(std::vector<food> food_list)
     return allergens | rv::join(',') | rs::to<std::string>;
 }
 
-#ifndef UNIT_TESTING
-
-int main()
-{
-    fmt::print("Advent of Code 2020 - Day 21\n");
-
-    std::string input_path = "days/day21/puzzle.in";
-
-    auto food_list = read_input(std::ifstream{input_path});
+const aoc::day_registrar registrar{
+    21,
+    [](const auto& input_path) { return read_input(std::ifstream{input_path}); },
+    part1,
+    part2};
 
-    fmt::print("Part 1 Solution: {}\n", part1(food_list));
-    fmt::print("Part 2 Solution: {}\n", part2(food_list));
-
-    return 0;
-}
+} // namespace
 
-#else
+#ifdef UNIT_TESTING
 
 #define CATCH_CONFIG_MAIN
 #include <catch2/catch.hpp>
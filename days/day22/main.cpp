@@ -1,4 +1,5 @@
-#include <fmt/format.h>
+#include <aoc2020/registry.hpp>
+
 #include <range/v3/all.hpp>
 
 #include <deque>
@@ -9,6 +10,8 @@
 namespace rs = ranges;
 namespace rv = ranges::views;
 
+namespace {
+
 std::vector<std::deque<int>> read_starting_decks(std::istream&& input)
 {
     return rs::getlines(input) | rv::split("") | rv::transform([](auto&& rng) {
@@ -104,23 +107,15 @@ int64_t part2(std::vector<std::deque<int>> decks)
     return calculate_deck_score(play_recursive_combat(decks).second);
 }
 
-#ifndef UNIT_TESTING
-
-int main()
-{
-    fmt::print("Advent of Code 2020 - Day 22\n");
-
-    std::string input_path = "days/day22/puzzle.in";
-
-    auto decks = read_starting_decks(std::ifstream{input_path});
+const aoc::day_registrar registrar{
+    22,
+    [](const auto& input_path) { return read_starting_decks(std::ifstream{input_path}); },
+    part1,
+    part2};
 
-    fmt::print("Part 1 Solution: {}\n", part1(decks));
-    fmt::print("Part 2 Solution: {}\n", part2(decks));
-
-    return 0;
-}
+} // namespace
 
-#else
+#ifdef UNIT_TESTING
 
 #define CATCH_CONFIG_MAIN
 #include <catch2/catch.hpp>
@@ -1,12 +1,18 @@
-#include <fmt/format.h>
+#include <aoc2020/aoc2020.hpp>
+#include <aoc2020/registry.hpp>
+
 #include <range/v3/all.hpp>
 
-#include <fstream>
 #include <list>
+#include <stdexcept>
+#include <string>
+#include <string_view>
 
 namespace rs = ranges;
 namespace rv = ranges::views;
 
+namespace {
+
 std::vector<int> parse_input1(const std::string& input, int size)
 {
     std::vector<int> cups;
@@ -91,21 +97,29 @@ int64_t part2(const std::string& input)
     return static_cast<int64_t>(cups[1]) * static_cast<int64_t>(cups[cups[1]]);
 }
 
-#ifndef UNIT_TESTING
-
-int main()
+// The cup labels on the first line of buffer, each a digit from 1 to 9.
+std::string read_cups(std::string_view buffer)
 {
-    fmt::print("Advent of Code 2020 - Day 23\n");
+    auto lines = aoc::lines(buffer);
+    auto first = lines.begin();
 
-    std::string input = "589174263";
-
-    fmt::print("Part 1 Solution: {}\n", part1(input));
-    fmt::print("Part 2 Solution: {}\n", part2(input));
+    if (first == lines.end() || (*first).empty()
+        || (*first).find_first_not_of("123456789") != std::string_view::npos) {
+        throw std::runtime_error{"Invalid input received"};
+    }
 
-    return 0;
+    return std::string{*first};
 }
 
-#else
+const aoc::day_registrar registrar{
+    23,
+    [](const auto& input_path) { return read_cups(aoc::mapped_input{input_path}.view()); },
+    part1,
+    part2};
+
+} // namespace
+
+#ifdef UNIT_TESTING
 
 #define CATCH_CONFIG_MAIN
 #include <catch2/catch.hpp>
@@ -121,4 +135,12 @@ TEST_CASE("Can solve part 2 example")
     REQUIRE(149245887792 == part2("389125467"));
 }
 
+TEST_CASE("Rejects missing or malformed cups")
+{
+    REQUIRE(std::string{"389125467"} == read_cups("389125467\r\n"));
+    REQUIRE_THROWS_AS(read_cups(""), std::runtime_error);
+    REQUIRE_THROWS_AS(read_cups("\n389125467\n"), std::runtime_error);
+    REQUIRE_THROWS_AS(read_cups("38912546x\n"), std::runtime_error);
+}
+
 #endif
@@ -1,4 +1,6 @@
-#include <fmt/format.h>
+#include <aoc2020/registry.hpp>
+#include <aoc2020/trace.hpp>
+
 #define GLM_ENABLE_EXPERIMENTAL
 #include "glm/gtx/hash.hpp"
 #include <glm/vec3.hpp>
@@ -11,6 +13,8 @@
 namespace rs = ranges;
 namespace rv = ranges::views;
 
+namespace {
+
 void pad_grid(std::unordered_map<glm::ivec3, int>& grid)
 {
     for (auto [pos, val] : grid) {
@@ -90,6 +94,9 @@ int64_t part2(std::unordered_map<glm::ivec3, int> grid)
 {
     int64_t black_tiles = 0;
     for (int i = 0; i < 100; ++i) {
+        AOC_TRACE_SCOPE("day24/flip_day");
+        AOC_TRACE_COUNT("day24/tiles_visited", grid.size());
+
         auto tmp = grid;
 
         for (auto [pos, tile] : grid) {
@@ -111,25 +118,18 @@ int64_t part2(std::unordered_map<glm::ivec3, int> grid)
     return black_tiles;
 }
 
-#ifndef UNIT_TESTING
-
-int main()
-{
-    fmt::print("Advent of Code 2020 - Day 24\n");
-
-    std::string input_path = "days/day24/puzzle.in";
-
-    std::ifstream ifs{input_path};
-
-    auto grid = read_input(ifs);
+const aoc::day_registrar registrar{
+    24,
+    [](const auto& input_path) {
+        std::ifstream ifs{input_path};
+        return read_input(ifs);
+    },
+    part1,
+    part2};
 
-    fmt::print("Part 1 Solution: {}\n", part1(grid));
-    fmt::print("Part 2 Solution: {}\n", part2(grid));
-
-    return 0;
-}
+} // namespace
 
-#else
+#ifdef UNIT_TESTING
 
 #define CATCH_CONFIG_MAIN
 #include <catch2/catch.hpp>
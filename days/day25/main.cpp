@@ -1,16 +1,12 @@
-#include <fmt/format.h>
-#include <range/v3/all.hpp>
+#include <aoc2020/aoc2020.hpp>
+#include <aoc2020/registry.hpp>
 
-#include <fstream>
+#include <range/v3/all.hpp>
 
 namespace rs = ranges;
 namespace rv = ranges::views;
 
-std::vector<int> read_input(std::istream& input)
-{
-    return rs::getlines(input)
-           | rv::transform([](auto&& s) { return std::stoi(s | rs::to<std::string>); }) | rs::to_vector;
-}
+namespace {
 
 int64_t transform_subject(int subject, int loop_size)
 {
@@ -37,21 +33,14 @@ int64_t part1(std::vector<int> public_keys)
     return transform_subject(public_keys[1], loops_to_reach(7, public_keys[0]));
 }
 
-#ifndef UNIT_TESTING
+const aoc::day_registrar registrar{
+    25,
+    [](const auto& input_path) { return aoc::read_int_per_line(aoc::mapped_input{input_path}.view()); },
+    part1};
 
-int main()
-{
-    fmt::print("Advent of Code 2020 - Day 25\n");
-
-    std::ifstream ifs{"days/day25/puzzle.in"};
-    auto          public_keys = read_input(ifs);
-
-    fmt::print("Part 1 Solution: {}\n", part1(public_keys));
-
-    return 0;
-}
+} // namespace
 
-#else
+#ifdef UNIT_TESTING
 
 #define CATCH_CONFIG_MAIN
 #include <catch2/catch.hpp>
@@ -76,7 +65,7 @@ TEST_CASE("Can solve part 1 example")
     ss << R"(5764801
 17807724)";
 
-    auto public_keys = read_input(ss);
+    auto public_keys = aoc::read_int_per_line(std::move(ss));
 
     REQUIRE(14897079 == part1(public_keys));
 }
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+// Allocation accounting for the calling thread. The counters only move when the replacement
+// operator new/delete from the aoc2020_alloc_hooks object library (the AOC2020_ALLOC_TRACKING CMake
+// option) is linked into the executable; enabled() reports whether it was.
+//
+//   aoc::alloc::scope allocs;
+//   auto answer = part1(input);
+//   auto used   = allocs.totals();
+//
+// Memory freed on a different thread than it was allocated on counts against the freeing thread.
+namespace aoc::alloc {
+
+struct stats {
+    int64_t count           = 0;
+    int64_t bytes           = 0;
+    int64_t peak_live_bytes = 0;
+};
+
+bool enabled() noexcept;
+
+// Measures allocations made on this thread between construction and totals(). Scopes nest; the
+// peak is relative to the live bytes when the scope was opened.
+class scope {
+public:
+    scope() noexcept;
+    ~scope();
+
+    scope(const scope&) = delete;
+    scope& operator=(const scope&) = delete;
+
+    stats totals() const noexcept;
+
+private:
+    int64_t count_;
+    int64_t bytes_;
+    int64_t live_;
+    int64_t outer_peak_;
+};
+
+namespace detail {
+    void install() noexcept;
+    void on_allocate(std::size_t size) noexcept;
+    void on_deallocate(std::size_t size) noexcept;
+} // namespace detail
+
+} // namespace aoc::alloc
@@ -1,11 +1,228 @@
-
 #pragma once
 
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
 #include <iosfwd>
+#include <iterator>
+#include <ranges>
+#include <span>
+#include <string>
+#include <string_view>
 #include <vector>
 
 namespace aoc {
 
 std::vector<int> read_int_per_line(std::istream&& input);
+std::vector<int> read_int_per_line(std::string_view buffer);
+
+std::vector<int64_t> read_int64_per_line(std::istream&& input);
+std::vector<int64_t> read_int64_per_line(std::string_view buffer);
+
+// Number of lines in buffer, counting a trailing line without a newline.
+std::size_t count_lines(std::string_view buffer) noexcept;
+
+// Parse one integer per line of buffer into out, skipping blank lines. Returns the number of values
+// written, which is at most out.size(). Throws std::runtime_error on a line that is not a single
+// integer or does not fit the element type. Line boundaries are found with SSE2/AVX2 when the
+// target supports them.
+std::size_t parse_int_per_line(std::string_view buffer, std::span<int> out);
+std::size_t parse_int_per_line(std::string_view buffer, std::span<int64_t> out);
+
+// Comma separated integers such as "1,5,12", as taken by the --days and --scales options. Throws
+// std::invalid_argument on an item that is not a whole integer of type T. Defined for int and int64_t.
+template <typename T>
+std::vector<T> parse_list(std::string_view list);
+
+// text as the contents of a JSON string: quotes and backslashes are escaped and control characters
+// written as \u00XX.
+std::string json_escape(std::string_view text);
+
+// Occurrences of c in buffer, compared 32 (AVX2) or 16 (SSE2) bytes at a time.
+std::size_t count_byte(std::string_view buffer, char c) noexcept;
+
+// Occurrences of c in the length bytes of buffer starting at offset. Bytes past that run, up to the
+// end of buffer, may be read too, so a short run is counted with one vector load masked to its length.
+std::size_t count_byte(std::string_view buffer, std::size_t offset, std::size_t length, char c) noexcept;
+
+// The length bytes of a buffer starting at offset, and the byte to count in them.
+struct byte_run {
+    std::size_t offset;
+    std::size_t length;
+    char        c;
+};
+
+// Writes the occurrences of runs[i].c in run i of buffer to counts[i]; counts must be at least as
+// long as runs. Short runs that fit in one 32 (AVX2) or 16 (SSE2) byte window starting at the first
+// of them share that load: the window is compared against each run's byte and the match mask is cut
+// to the run. Runs in increasing offset order, such as consecutive lines, batch best.
+void count_bytes(std::string_view buffer, std::span<const byte_run> runs,
+                 std::span<std::size_t> counts) noexcept;
+
+enum class split_by { line, blank_line };
+
+// Forward iterator over the lines (or blank-line separated records) of a buffer. Every token is a
+// view into the underlying buffer, trailing '\r' characters are dropped so CRLF inputs behave the
+// same as LF inputs.
+class delimited_iterator {
+public:
+    using iterator_concept  = std::forward_iterator_tag;
+    using iterator_category = std::input_iterator_tag;
+    using value_type        = std::string_view;
+    using difference_type   = std::ptrdiff_t;
+    using reference         = std::string_view;
+    using pointer           = void;
+
+    delimited_iterator() = default;
+
+    delimited_iterator(std::string_view buffer, split_by mode)
+        : rest_{buffer}
+        , mode_{mode}
+    {
+        advance();
+    }
+
+    std::string_view operator*() const noexcept { return token_; }
+
+    delimited_iterator& operator++()
+    {
+        advance();
+        return *this;
+    }
+
+    delimited_iterator operator++(int)
+    {
+        auto tmp = *this;
+        advance();
+        return tmp;
+    }
+
+    friend bool operator==(const delimited_iterator& a, const delimited_iterator& b) noexcept
+    {
+        return a.done_ == b.done_ && (a.done_ || a.token_.data() == b.token_.data());
+    }
+
+private:
+    static std::string_view trim_cr(std::string_view s) noexcept
+    {
+        if (!s.empty() && s.back() == '\r') s.remove_suffix(1);
+        return s;
+    }
+
+    std::string_view next_line() noexcept
+    {
+        auto pos  = rest_.find('\n');
+        auto line = rest_.substr(0, pos);
+
+        rest_.remove_prefix(pos == std::string_view::npos ? rest_.size() : pos + 1);
+
+        return trim_cr(line);
+    }
+
+    void advance() noexcept
+    {
+        if (mode_ == split_by::line) {
+            done_ = rest_.empty();
+            if (!done_) token_ = next_line();
+            return;
+        }
+
+        std::string_view line;
+        while (!rest_.empty() && (line = next_line()).empty()) {}
+
+        done_ = line.empty();
+        if (done_) return;
+
+        const char* first = line.data();
+        const char* last  = line.data() + line.size();
+
+        while (!rest_.empty() && !(line = next_line()).empty()) {
+            last = line.data() + line.size();
+        }
+
+        token_ = std::string_view{first, static_cast<std::size_t>(last - first)};
+    }
+
+    std::string_view rest_;
+    std::string_view token_;
+    split_by         mode_ = split_by::line;
+    bool             done_ = true;
+};
+
+class delimited_range : public std::ranges::view_interface<delimited_range> {
+public:
+    delimited_range() = default;
+
+    delimited_range(std::string_view buffer, split_by mode)
+        : buffer_{buffer}
+        , mode_{mode}
+    {
+    }
+
+    delimited_iterator begin() const { return {buffer_, mode_}; }
+    delimited_iterator end() const { return {}; }
+
+private:
+    std::string_view buffer_;
+    split_by         mode_ = split_by::line;
+};
+
+inline delimited_range lines(std::string_view buffer)
+{
+    return {buffer, split_by::line};
+}
+
+inline delimited_range records(std::string_view buffer)
+{
+    return {buffer, split_by::blank_line};
+}
+
+// Read-only memory mapping of an input file. The views handed out by view(), lines() and records()
+// point into the mapping and are only valid for as long as the mapped_input is alive.
+class mapped_input {
+public:
+    explicit mapped_input(const std::filesystem::path& path);
+    ~mapped_input();
+
+    mapped_input(mapped_input&& other) noexcept;
+    mapped_input& operator=(mapped_input&& other) noexcept;
+
+    mapped_input(const mapped_input&) = delete;
+    mapped_input& operator=(const mapped_input&) = delete;
+
+    std::string_view view() const noexcept { return {data_, size_}; }
+
+    delimited_range lines() const noexcept { return aoc::lines(view()); }
+    delimited_range records() const noexcept { return aoc::records(view()); }
+
+private:
+    void unmap() noexcept;
+
+    const char* data_ = nullptr;
+    std::size_t size_ = 0;
+};
+
+// Machine code copied into freshly mapped pages that are then made read-only and executable, so
+// the memory is never writable and executable at the same time. Throws std::system_error when the
+// system refuses to map or protect the pages.
+class executable_code {
+public:
+    explicit executable_code(std::span<const uint8_t> code);
+    ~executable_code();
+
+    executable_code(executable_code&& other) noexcept;
+    executable_code& operator=(executable_code&& other) noexcept;
+
+    executable_code(const executable_code&) = delete;
+    executable_code& operator=(const executable_code&) = delete;
+
+    const void* entry() const noexcept { return data_; }
+
+private:
+    void release() noexcept;
+
+    void*       data_ = nullptr;
+    std::size_t size_ = 0;
+};
 
 } // namespace aoc
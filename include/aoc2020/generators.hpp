@@ -0,0 +1,29 @@
+#pragma once
+
+#include <fmt/format.h>
+
+#include <cstdint>
+#include <span>
+#include <string_view>
+
+namespace aoc {
+
+// Synthetic puzzle input writer for one day. scale describes what the scale parameter controls
+// (lines, passports, grid side, ...); default_scale roughly matches the real puzzle input. Every
+// generated input is valid for that day's solver, and the same scale and seed always produce the
+// same bytes on every platform.
+struct input_generator {
+    int              day;
+    std::string_view scale;
+    int64_t          min_scale;
+    int64_t          max_scale;
+    int64_t          default_scale;
+    void (*generate)(fmt::memory_buffer& out, int64_t scale, uint64_t seed);
+};
+
+// Every day with a generator, ordered by day number.
+std::span<const input_generator> input_generators();
+
+const input_generator* find_generator(int day);
+
+} // namespace aoc
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string_view>
+
+namespace aoc {
+
+inline constexpr std::array<std::string_view, 5> perf_counter_names{
+    "cycles",
+    "instructions",
+    "l1d_misses",
+    "llc_misses",
+    "branch_misses"};
+
+// One reading per entry of perf_counter_names; empty where the counter could not be opened.
+using perf_sample = std::array<std::optional<int64_t>, perf_counter_names.size()>;
+
+// Hardware counters for the calling thread only, opened as one perf_event_open group on Linux so
+// every reading covers the same interval. Work handed to other threads, such as aoc::shared_pool(),
+// is not counted. Counters the kernel refuses (perf_event_paranoid, virtual machines without a PMU,
+// other platforms) are skipped, so callers can always use start()/stop() and fall back to wall time
+// when available() is false.
+class perf_counters {
+public:
+    perf_counters();
+    ~perf_counters();
+
+    perf_counters(const perf_counters&) = delete;
+    perf_counters& operator=(const perf_counters&) = delete;
+
+    bool available() const noexcept;
+
+    void        start() noexcept;
+    perf_sample stop() noexcept;
+
+private:
+    std::array<int, perf_counter_names.size()> fds_;
+    int                                        leader_ = -1;
+};
+
+} // namespace aoc
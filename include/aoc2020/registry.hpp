@@ -0,0 +1,62 @@
+#pragma once
+
+#include "trace.hpp"
+
+#include <fmt/format.h>
+
+#include <filesystem>
+#include <functional>
+#include <memory>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+namespace aoc {
+
+// Type-erased result of a day's parse step, shared read-only between its parts.
+using parsed_input = std::shared_ptr<const void>;
+
+struct day_solution {
+    int                                                          day;
+    std::function<parsed_input(const std::filesystem::path&)>    parse;
+    std::vector<std::function<std::string(const parsed_input&)>> parts;
+};
+
+void register_day(day_solution solution);
+
+// Every registered day, ordered by day number.
+const std::vector<day_solution>& registered_days();
+
+const day_solution* find_day(int day);
+
+std::filesystem::path default_input_path(int day);
+
+// Registers a day at static initialization time. parse is invoked with the input path and may
+// return any movable type; each part receives that value by const reference and returns anything
+// fmt can format. Every step is traced as dayNN/parse, dayNN/part1, ...
+class day_registrar {
+public:
+    template <typename Parse, typename... Parts>
+    day_registrar(int day, Parse parse, Parts... parts)
+    {
+        using input_type = std::decay_t<std::invoke_result_t<const Parse&, const std::filesystem::path&>>;
+
+        int part_number = 0;
+
+        register_day(
+            {day,
+             [parse, phase = trace::phase{fmt::format("day{:02}/parse", day)}](
+                 const std::filesystem::path& input_path) -> parsed_input {
+                 trace::scope timer{phase};
+                 return std::make_shared<const input_type>(parse(input_path));
+             },
+             {[part  = parts,
+               phase = trace::phase{fmt::format("day{:02}/part{}", day, ++part_number)}](
+                  const parsed_input& input) {
+                 trace::scope timer{phase};
+                 return fmt::format("{}", part(*static_cast<const input_type*>(input.get())));
+             }...}});
+    }
+};
+
+} // namespace aoc
@@ -0,0 +1,57 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace aoc {
+
+// Fixed-size pool of worker threads pulling tasks from a shared FIFO queue. Tasks start in the
+// order they were submitted; the destructor finishes every queued task before joining.
+class thread_pool {
+public:
+    explicit thread_pool(std::size_t threads = std::thread::hardware_concurrency());
+    ~thread_pool();
+
+    thread_pool(const thread_pool&) = delete;
+    thread_pool& operator=(const thread_pool&) = delete;
+
+    std::size_t size() const noexcept { return workers_.size(); }
+
+    template <typename F>
+    std::future<std::invoke_result_t<std::decay_t<F>>> submit(F&& f)
+    {
+        using result_type = std::invoke_result_t<std::decay_t<F>>;
+
+        auto task   = std::make_shared<std::packaged_task<result_type()>>(std::forward<F>(f));
+        auto result = task->get_future();
+
+        enqueue([task] { (*task)(); });
+
+        return result;
+    }
+
+private:
+    void enqueue(std::function<void()> task);
+    void work();
+
+    std::vector<std::thread>          workers_;
+    std::deque<std::function<void()>> tasks_;
+    std::mutex                        mutex_;
+    std::condition_variable           ready_;
+    bool                              stopping_ = false;
+};
+
+// Process-wide pool for data-parallel work inside a single part, started on first use with one
+// worker per hardware thread. It is never the pool the parts themselves run on, so a part may block
+// on tasks it submitted here, but those tasks must not wait on other shared_pool() work.
+thread_pool& shared_pool();
+
+} // namespace aoc
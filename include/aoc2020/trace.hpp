@@ -0,0 +1,138 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <string_view>
+
+#ifdef AOC2020_TRACE
+#include <chrono>
+#endif
+
+// Lightweight hot-path instrumentation. Building with AOC2020_TRACE defined (the AOC2020_TRACE CMake
+// option) enables it; otherwise every type below is empty and every call compiles to nothing.
+//
+//   void run_cycle(grid& g)
+//   {
+//       AOC_TRACE_SCOPE("day17/run_cycle");
+//       AOC_TRACE_COUNT("day17/cells", g.size());
+//       ...
+//   }
+//
+// Per-phase totals and counter values are written to stderr when the program exits. After
+// write_timeline() every scope is also kept as a Chrome trace_event, and the timeline is written
+// to the given file at exit for viewing in Perfetto or about:tracing.
+namespace aoc::trace {
+
+#ifdef AOC2020_TRACE
+
+inline constexpr bool enabled = true;
+
+namespace detail {
+    std::size_t register_phase(std::string_view name);
+    std::size_t register_counter(std::string_view name);
+
+    void record_phase(std::size_t id, int64_t start_ns, int64_t stop_ns) noexcept;
+    void add_counter(std::size_t id, int64_t amount) noexcept;
+} // namespace detail
+
+void write_timeline(const std::filesystem::path& path);
+
+class phase {
+public:
+    explicit phase(std::string_view name)
+        : id_{detail::register_phase(name)}
+    {
+    }
+
+    std::size_t id() const noexcept { return id_; }
+
+private:
+    std::size_t id_;
+};
+
+class scope {
+public:
+    explicit scope(const phase& p) noexcept
+        : id_{p.id()}
+        , start_{std::chrono::steady_clock::now()}
+    {
+    }
+
+    ~scope()
+    {
+        auto to_ns = [](auto t) {
+            return std::chrono::duration_cast<std::chrono::nanoseconds>(t.time_since_epoch()).count();
+        };
+
+        detail::record_phase(id_, to_ns(start_), to_ns(std::chrono::steady_clock::now()));
+    }
+
+    scope(const scope&) = delete;
+    scope& operator=(const scope&) = delete;
+
+private:
+    std::size_t                           id_;
+    std::chrono::steady_clock::time_point start_;
+};
+
+class counter {
+public:
+    explicit counter(std::string_view name)
+        : id_{detail::register_counter(name)}
+    {
+    }
+
+    void add(int64_t amount = 1) const noexcept { detail::add_counter(id_, amount); }
+
+private:
+    std::size_t id_;
+};
+
+#else
+
+inline constexpr bool enabled = false;
+
+inline void write_timeline(const std::filesystem::path&) {}
+
+class phase {
+public:
+    explicit constexpr phase(std::string_view) noexcept {}
+};
+
+class scope {
+public:
+    explicit constexpr scope(const phase&) noexcept {}
+};
+
+class counter {
+public:
+    explicit constexpr counter(std::string_view) noexcept {}
+
+    constexpr void add(int64_t = 1) const noexcept {}
+};
+
+#endif
+
+} // namespace aoc::trace
+
+#define AOC_TRACE_CONCAT_IMPL(a, b) a##b
+#define AOC_TRACE_CONCAT(a, b) AOC_TRACE_CONCAT_IMPL(a, b)
+
+#ifdef AOC2020_TRACE
+#define AOC_TRACE_SCOPE(name)                                                                       \
+    static const aoc::trace::phase AOC_TRACE_CONCAT(aoc_trace_phase_, __LINE__){name};              \
+    const aoc::trace::scope        AOC_TRACE_CONCAT(aoc_trace_scope_, __LINE__)                     \
+    {                                                                                               \
+        AOC_TRACE_CONCAT(aoc_trace_phase_, __LINE__)                                                \
+    }
+
+#define AOC_TRACE_COUNT(name, amount)                                                               \
+    do {                                                                                            \
+        static const aoc::trace::counter aoc_trace_counter{name};                                   \
+        aoc_trace_counter.add(static_cast<int64_t>(amount));                                        \
+    } while (false)
+#else
+#define AOC_TRACE_SCOPE(name) static_cast<void>(0)
+#define AOC_TRACE_COUNT(name, amount) static_cast<void>(0)
+#endif
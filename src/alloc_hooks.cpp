@@ -0,0 +1,105 @@
+#include <aoc2020/alloc_tracker.hpp>
+
+#include <cstddef>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+
+// Global operator new/delete replacements feeding aoc::alloc. Every block carries its size in a
+// header so deletes can be accounted without relying on sized deallocation. The over-aligned
+// overloads are left to the standard library and are not counted.
+
+namespace {
+
+constexpr std::size_t header_size = alignof(std::max_align_t);
+
+void* tracked_allocate(std::size_t size) noexcept
+{
+    auto* block = static_cast<unsigned char*>(std::malloc(size + header_size));
+
+    if (block == nullptr) return nullptr;
+
+    std::memcpy(block, &size, sizeof(size));
+    aoc::alloc::detail::on_allocate(size);
+
+    return block + header_size;
+}
+
+void tracked_free(void* ptr) noexcept
+{
+    if (ptr == nullptr) return;
+
+    auto*       block = static_cast<unsigned char*>(ptr) - header_size;
+    std::size_t size;
+
+    std::memcpy(&size, block, sizeof(size));
+    aoc::alloc::detail::on_deallocate(size);
+
+    std::free(block);
+}
+
+const bool installed = (aoc::alloc::detail::install(), true);
+
+} // namespace
+
+void* operator new(std::size_t size)
+{
+    while (true) {
+        if (void* ptr = tracked_allocate(size)) return ptr;
+
+        auto handler = std::get_new_handler();
+        if (handler == nullptr) throw std::bad_alloc{};
+
+        handler();
+    }
+}
+
+void* operator new[](std::size_t size)
+{
+    return operator new(size);
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept
+{
+    try {
+        return operator new(size);
+    }
+    catch (...) {
+        return nullptr;
+    }
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept
+{
+    return operator new(size, std::nothrow);
+}
+
+void operator delete(void* ptr) noexcept
+{
+    tracked_free(ptr);
+}
+
+void operator delete[](void* ptr) noexcept
+{
+    tracked_free(ptr);
+}
+
+void operator delete(void* ptr, std::size_t) noexcept
+{
+    tracked_free(ptr);
+}
+
+void operator delete[](void* ptr, std::size_t) noexcept
+{
+    tracked_free(ptr);
+}
+
+void operator delete(void* ptr, const std::nothrow_t&) noexcept
+{
+    tracked_free(ptr);
+}
+
+void operator delete[](void* ptr, const std::nothrow_t&) noexcept
+{
+    tracked_free(ptr);
+}
@@ -0,0 +1,71 @@
+#include "alloc_tracker.hpp"
+
+#include <algorithm>
+#include <atomic>
+
+namespace aoc::alloc {
+
+namespace {
+
+    struct thread_counters {
+        int64_t count = 0;
+        int64_t bytes = 0;
+        int64_t live  = 0;
+        int64_t peak  = 0;
+    };
+
+    // Both are constant-initialized, so allocations made before main() are safe to count.
+    std::atomic<bool>            installed{false};
+    thread_local thread_counters current;
+
+} // namespace
+
+bool enabled() noexcept
+{
+    return installed.load(std::memory_order_relaxed);
+}
+
+scope::scope() noexcept
+    : count_{current.count}
+    , bytes_{current.bytes}
+    , live_{current.live}
+    , outer_peak_{current.peak}
+{
+    current.peak = current.live;
+}
+
+scope::~scope()
+{
+    current.peak = std::max(current.peak, outer_peak_);
+}
+
+stats scope::totals() const noexcept
+{
+    return {current.count - count_, current.bytes - bytes_, std::max<int64_t>(current.peak - live_, 0)};
+}
+
+namespace detail {
+
+    void install() noexcept
+    {
+        installed.store(true, std::memory_order_relaxed);
+    }
+
+    void on_allocate(std::size_t size) noexcept
+    {
+        auto& c = current;
+
+        c.count += 1;
+        c.bytes += static_cast<int64_t>(size);
+        c.live += static_cast<int64_t>(size);
+        c.peak = std::max(c.peak, c.live);
+    }
+
+    void on_deallocate(std::size_t size) noexcept
+    {
+        current.live -= static_cast<int64_t>(size);
+    }
+
+} // namespace detail
+
+} // namespace aoc::alloc
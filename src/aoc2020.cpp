@@ -1,17 +1,565 @@
-
 #include "aoc2020.hpp"
 
-#include <range/v3/all.hpp>
+#include <algorithm>
+#include <bit>
+#include <cerrno>
+#include <charconv>
+#include <cstring>
+#include <istream>
+#include <iterator>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <utility>
+
+#ifdef _WIN32
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
 
-namespace rs = ranges;
-namespace rv = ranges::views;
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define AOC_HAS_SSE2
+#endif
 
 namespace aoc {
 
+namespace {
+
+    // Invokes f with the offset of every '\n' in buffer, in order.
+    template <typename F>
+    void for_each_newline(std::string_view buffer, F&& f)
+    {
+        const char* data = buffer.data();
+        std::size_t size = buffer.size();
+        std::size_t i    = 0;
+
+#if defined(__AVX2__)
+        const __m256i newline = _mm256_set1_epi8('\n');
+
+        for (; i + 32 <= size; i += 32) {
+            auto chunk = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i));
+            auto mask  = static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(chunk, newline)));
+
+            for (; mask != 0; mask &= mask - 1) {
+                f(i + std::countr_zero(mask));
+            }
+        }
+#elif defined(AOC_HAS_SSE2)
+        const __m128i newline = _mm_set1_epi8('\n');
+
+        for (; i + 16 <= size; i += 16) {
+            auto chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+            auto mask  = static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(chunk, newline)));
+
+            for (; mask != 0; mask &= mask - 1) {
+                f(i + std::countr_zero(mask));
+            }
+        }
+#endif
+
+        for (; i < size; ++i) {
+            if (data[i] == '\n') f(i);
+        }
+    }
+
+    [[noreturn]] void throw_bad_line(std::size_t line, const char* problem)
+    {
+        throw std::runtime_error{"Line " + std::to_string(line) + " " + problem};
+    }
+
+    // An optional sign and digits, optionally surrounded by blanks. Returns false for a blank line
+    // and throws std::runtime_error when the line holds anything else or its value does not fit T.
+    template <typename T>
+    bool parse_line(const char* first, const char* last, T& value, std::size_t line)
+    {
+        auto blank = [](char c) { return c == ' ' || c == '\t' || c == '\r'; };
+
+        while (first != last && blank(*first)) {
+            ++first;
+        }
+        while (last != first && blank(last[-1])) {
+            --last;
+        }
+
+        if (first == last) return false;
+
+        bool negative = false;
+        if (*first == '-' || *first == '+') negative = (*first++ == '-');
+
+        if (first == last) throw_bad_line(line, "is not an integer");
+
+        // Magnitude bounds in the style of strtol: one more digit is allowed while the value so far
+        // is below cutoff, or equal to it and the digit is at most last_digit.
+        const uint64_t limit      = static_cast<uint64_t>(std::numeric_limits<T>::max()) + negative;
+        const uint64_t cutoff     = limit / 10;
+        const uint64_t last_digit = limit % 10;
+
+        uint64_t result = 0;
+
+        for (; first != last; ++first) {
+            auto digit = static_cast<unsigned char>(*first - '0');
+
+            if (digit > 9) throw_bad_line(line, "is not an integer");
+            if (result > cutoff || (result == cutoff && digit > last_digit)) {
+                throw_bad_line(line, "is out of range");
+            }
+
+            result = result * 10 + digit;
+        }
+
+        value = static_cast<T>(negative ? 0 - result : result);
+        return true;
+    }
+
+    template <typename T>
+    std::size_t parse_int_per_line_impl(std::string_view buffer, std::span<T> out)
+    {
+        const char* data  = buffer.data();
+        std::size_t start = 0;
+        std::size_t count = 0;
+        std::size_t line  = 0;
+
+        auto parse_until = [&](std::size_t end) {
+            ++line;
+            if (count < out.size() && parse_line(data + start, data + end, out[count], line)) ++count;
+            start = end + 1;
+        };
+
+        for_each_newline(buffer, parse_until);
+
+        if (start < buffer.size()) parse_until(buffer.size());
+
+        return count;
+    }
+
+    template <typename T>
+    std::vector<T> read_per_line(std::string_view buffer)
+    {
+        std::vector<T> values(count_lines(buffer));
+        values.resize(parse_int_per_line(buffer, std::span<T>{values}));
+        return values;
+    }
+
+    std::string read_all(std::istream& input)
+    {
+        return {std::istreambuf_iterator<char>{input}, std::istreambuf_iterator<char>{}};
+    }
+
+} // namespace
+
+std::size_t count_lines(std::string_view buffer) noexcept
+{
+    std::size_t lines = 0;
+
+    for_each_newline(buffer, [&lines](std::size_t) { ++lines; });
+
+    return (buffer.empty() || buffer.back() == '\n') ? lines : lines + 1;
+}
+
+template <typename T>
+std::vector<T> parse_list(std::string_view list)
+{
+    std::vector<T> values;
+
+    while (!list.empty()) {
+        auto item = list.substr(0, list.find(','));
+        T    value{};
+
+        auto [end, error] = std::from_chars(item.data(), item.data() + item.size(), value);
+        if (error != std::errc{} || end != item.data() + item.size()) {
+            throw std::invalid_argument{"Invalid list item \"" + std::string{item} + "\""};
+        }
+
+        values.push_back(value);
+        list.remove_prefix(std::min(item.size() + 1, list.size()));
+    }
+
+    return values;
+}
+
+template std::vector<int>     parse_list<int>(std::string_view list);
+template std::vector<int64_t> parse_list<int64_t>(std::string_view list);
+
+std::string json_escape(std::string_view text)
+{
+    constexpr std::string_view hex_digits = "0123456789abcdef";
+
+    std::string escaped;
+    escaped.reserve(text.size());
+
+    for (char c : text) {
+        auto byte = static_cast<unsigned char>(c);
+
+        if (c == '"' || c == '\\') {
+            escaped += '\\';
+            escaped += c;
+        }
+        else if (byte < 0x20) {
+            escaped += "\\u00";
+            escaped += hex_digits[byte >> 4];
+            escaped += hex_digits[byte & 0xf];
+        }
+        else {
+            escaped += c;
+        }
+    }
+
+    return escaped;
+}
+
+std::size_t count_byte(std::string_view buffer, char c) noexcept
+{
+    return count_byte(buffer, 0, buffer.size(), c);
+}
+
+std::size_t count_byte(std::string_view buffer, std::size_t offset, std::size_t length, char c) noexcept
+{
+    const char* data     = buffer.data() + offset;
+    std::size_t readable = buffer.size() - offset;
+    std::size_t count    = 0;
+    std::size_t i        = 0;
+
+#if defined(__AVX2__)
+    const __m256i target = _mm256_set1_epi8(c);
+
+    auto matches = [&](std::size_t at) {
+        auto chunk = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + at));
+        return static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(chunk, target)));
+    };
+
+    for (; i + 32 <= length; i += 32) {
+        count += static_cast<std::size_t>(std::popcount(matches(i)));
+    }
+
+    if (i < length && i + 32 <= readable) {
+        auto tail = (uint32_t{1} << (length - i)) - 1;
+        return count + static_cast<std::size_t>(std::popcount(matches(i) & tail));
+    }
+#elif defined(AOC_HAS_SSE2)
+    const __m128i target = _mm_set1_epi8(c);
+
+    auto matches = [&](std::size_t at) {
+        auto chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + at));
+        return static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(chunk, target)));
+    };
+
+    for (; i + 16 <= length; i += 16) {
+        count += static_cast<std::size_t>(std::popcount(matches(i)));
+    }
+
+    if (i < length && i + 16 <= readable) {
+        auto tail = (uint32_t{1} << (length - i)) - 1;
+        return count + static_cast<std::size_t>(std::popcount(matches(i) & tail));
+    }
+#else
+    static_cast<void>(readable);
+#endif
+
+    for (; i < length; ++i) {
+        count += data[i] == c;
+    }
+
+    return count;
+}
+
+void count_bytes(std::string_view buffer, std::span<const byte_run> runs,
+                 std::span<std::size_t> counts) noexcept
+{
+    std::size_t r = 0;
+
+#if defined(__AVX2__)
+    constexpr std::size_t width = 32;
+
+    auto load    = [&buffer](std::size_t at) {
+        return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(buffer.data() + at));
+    };
+    auto matches = [](__m256i chunk, char c) {
+        return static_cast<uint64_t>(
+            static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(chunk, _mm256_set1_epi8(c)))));
+    };
+#elif defined(AOC_HAS_SSE2)
+    constexpr std::size_t width = 16;
+
+    auto load    = [&buffer](std::size_t at) {
+        return _mm_loadu_si128(reinterpret_cast<const __m128i*>(buffer.data() + at));
+    };
+    auto matches = [](__m128i chunk, char c) {
+        return static_cast<uint64_t>(
+            static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(chunk, _mm_set1_epi8(c)))));
+    };
+#endif
+
+#if defined(__AVX2__) || defined(AOC_HAS_SSE2)
+    while (r < runs.size()) {
+        auto window = runs[r].offset;
+
+        if (runs[r].length > width || window + width > buffer.size()) {
+            counts[r] = count_byte(buffer, runs[r].offset, runs[r].length, runs[r].c);
+            ++r;
+            continue;
+        }
+
+        // The first run always fits, so every window makes progress.
+        auto chunk = load(window);
+
+        for (; r < runs.size() && runs[r].offset >= window
+               && runs[r].offset + runs[r].length <= window + width;
+             ++r) {
+            auto run  = ((uint64_t{1} << runs[r].length) - 1) << (runs[r].offset - window);
+            counts[r] = static_cast<std::size_t>(std::popcount(matches(chunk, runs[r].c) & run));
+        }
+    }
+#endif
+
+    for (; r < runs.size(); ++r) {
+        counts[r] = count_byte(buffer, runs[r].offset, runs[r].length, runs[r].c);
+    }
+}
+
+std::size_t parse_int_per_line(std::string_view buffer, std::span<int> out)
+{
+    return parse_int_per_line_impl(buffer, out);
+}
+
+std::size_t parse_int_per_line(std::string_view buffer, std::span<int64_t> out)
+{
+    return parse_int_per_line_impl(buffer, out);
+}
+
 std::vector<int> read_int_per_line(std::istream&& input)
 {
-    return rs::getlines(input) | rv::transform([](auto&& s) { return std::stoi(s); })
-           | rs::to<std::vector>;
+    return read_per_line<int>(read_all(input));
+}
+
+std::vector<int> read_int_per_line(std::string_view buffer)
+{
+    return read_per_line<int>(buffer);
+}
+
+std::vector<int64_t> read_int64_per_line(std::istream&& input)
+{
+    return read_per_line<int64_t>(read_all(input));
+}
+
+std::vector<int64_t> read_int64_per_line(std::string_view buffer)
+{
+    return read_per_line<int64_t>(buffer);
+}
+
+#ifdef _WIN32
+
+mapped_input::mapped_input(const std::filesystem::path& path)
+{
+    auto fail = [&path](const char* what) {
+        return std::system_error{
+            static_cast<int>(::GetLastError()),
+            std::system_category(),
+            std::string{what} + " " + path.string()};
+    };
+
+    HANDLE file = ::CreateFileW(
+        path.c_str(),
+        GENERIC_READ,
+        FILE_SHARE_READ,
+        nullptr,
+        OPEN_EXISTING,
+        FILE_FLAG_SEQUENTIAL_SCAN,
+        nullptr);
+
+    if (file == INVALID_HANDLE_VALUE) throw fail("CreateFile");
+
+    LARGE_INTEGER file_size;
+    if (!::GetFileSizeEx(file, &file_size)) {
+        auto error = fail("GetFileSizeEx");
+        ::CloseHandle(file);
+        throw error;
+    }
+
+    if (file_size.QuadPart == 0) {
+        ::CloseHandle(file);
+        return;
+    }
+
+    HANDLE mapping = ::CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    ::CloseHandle(file);
+
+    if (mapping == nullptr) throw fail("CreateFileMapping");
+
+    auto* data = ::MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    ::CloseHandle(mapping);
+
+    if (data == nullptr) throw fail("MapViewOfFile");
+
+    data_ = static_cast<const char*>(data);
+    size_ = static_cast<std::size_t>(file_size.QuadPart);
+}
+
+void mapped_input::unmap() noexcept
+{
+    if (data_ != nullptr) ::UnmapViewOfFile(data_);
+}
+
+#else
+
+mapped_input::mapped_input(const std::filesystem::path& path)
+{
+    auto fail = [&path](const char* what) {
+        return std::system_error{errno, std::generic_category(), std::string{what} + " " + path.string()};
+    };
+
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) throw fail("open");
+
+    struct stat st;
+    if (::fstat(fd, &st) != 0) {
+        auto error = fail("fstat");
+        ::close(fd);
+        throw error;
+    }
+
+    if (st.st_size == 0) {
+        ::close(fd);
+        return;
+    }
+
+    void* data = ::mmap(nullptr, static_cast<std::size_t>(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+
+    if (data == MAP_FAILED) throw fail("mmap");
+
+    ::madvise(data, static_cast<std::size_t>(st.st_size), MADV_SEQUENTIAL);
+
+    data_ = static_cast<const char*>(data);
+    size_ = static_cast<std::size_t>(st.st_size);
+}
+
+void mapped_input::unmap() noexcept
+{
+    if (data_ != nullptr) ::munmap(const_cast<char*>(data_), size_);
+}
+
+#endif
+
+mapped_input::~mapped_input()
+{
+    unmap();
+}
+
+mapped_input::mapped_input(mapped_input&& other) noexcept
+    : data_{std::exchange(other.data_, nullptr)}
+    , size_{std::exchange(other.size_, 0)}
+{
+}
+
+mapped_input& mapped_input::operator=(mapped_input&& other) noexcept
+{
+    if (this != &other) {
+        unmap();
+        data_ = std::exchange(other.data_, nullptr);
+        size_ = std::exchange(other.size_, 0);
+    }
+
+    return *this;
+}
+
+#ifdef _WIN32
+
+executable_code::executable_code(std::span<const uint8_t> code)
+{
+    if (code.empty()) return;
+
+    auto fail = [](const char* what) {
+        return std::system_error{static_cast<int>(::GetLastError()), std::system_category(), what};
+    };
+
+    void* data = ::VirtualAlloc(nullptr, code.size(), MEM_COMMIT | MEM_RESERVE, PAGE_READWRITE);
+    if (data == nullptr) throw fail("VirtualAlloc");
+
+    std::memcpy(data, code.data(), code.size());
+
+    DWORD previous;
+    if (!::VirtualProtect(data, code.size(), PAGE_EXECUTE_READ, &previous)) {
+        auto error = fail("VirtualProtect");
+        ::VirtualFree(data, 0, MEM_RELEASE);
+        throw error;
+    }
+
+    ::FlushInstructionCache(::GetCurrentProcess(), data, code.size());
+
+    data_ = data;
+    size_ = code.size();
+}
+
+void executable_code::release() noexcept
+{
+    if (data_ != nullptr) ::VirtualFree(data_, 0, MEM_RELEASE);
+}
+
+#else
+
+executable_code::executable_code(std::span<const uint8_t> code)
+{
+    if (code.empty()) return;
+
+    auto fail = [](const char* what) { return std::system_error{errno, std::generic_category(), what}; };
+
+    void* data =
+        ::mmap(nullptr, code.size(), PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (data == MAP_FAILED) throw fail("mmap");
+
+    std::memcpy(data, code.data(), code.size());
+
+    if (::mprotect(data, code.size(), PROT_READ | PROT_EXEC) != 0) {
+        auto error = fail("mprotect");
+        ::munmap(data, code.size());
+        throw error;
+    }
+
+    data_ = data;
+    size_ = code.size();
+}
+
+void executable_code::release() noexcept
+{
+    if (data_ != nullptr) ::munmap(data_, size_);
+}
+
+#endif
+
+executable_code::~executable_code()
+{
+    release();
+}
+
+executable_code::executable_code(executable_code&& other) noexcept
+    : data_{std::exchange(other.data_, nullptr)}
+    , size_{std::exchange(other.size_, 0)}
+{
+}
+
+executable_code& executable_code::operator=(executable_code&& other) noexcept
+{
+    if (this != &other) {
+        release();
+        data_ = std::exchange(other.data_, nullptr);
+        size_ = std::exchange(other.size_, 0);
+    }
+
+    return *this;
 }
 
 } // namespace aoc
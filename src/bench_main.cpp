@@ -0,0 +1,404 @@
+#include <aoc2020/aoc2020.hpp>
+#include <aoc2020/alloc_tracker.hpp>
+#include <aoc2020/generators.hpp>
+#include <aoc2020/perf_counters.hpp>
+#include <aoc2020/registry.hpp>
+
+#include <fmt/core.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <exception>
+#include <filesystem>
+#include <numeric>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#ifdef _WIN32
+#include <process.h>
+#else
+#include <unistd.h>
+#endif
+
+namespace {
+
+struct options {
+    std::vector<int>     days;
+    int                  warmup = 1;
+    int                  runs   = 10;
+    std::string          output;
+    bool                 counters = false;
+    std::vector<int64_t> scales;
+    uint64_t             seed = 2020;
+};
+
+struct phase_result {
+    std::string                    name;
+    std::string                    answer;
+    std::vector<int64_t>           samples_ns;
+    std::vector<aoc::perf_sample>  counter_samples;
+    std::vector<aoc::alloc::stats> alloc_samples;
+};
+
+// counters is null when hardware counters are off or unavailable; only wall time is kept then.
+template <typename F>
+phase_result measure(std::string name, const options& opts, aoc::perf_counters* counters, F&& f)
+{
+    phase_result result{std::move(name), {}, {}, {}, {}};
+
+    for (int i = 0; i < opts.warmup; ++i) {
+        f();
+    }
+
+    for (int i = 0; i < opts.runs; ++i) {
+        aoc::alloc::scope allocs;
+
+        if (counters != nullptr) counters->start();
+
+        auto start = std::chrono::steady_clock::now();
+        auto value = f();
+        auto stop  = std::chrono::steady_clock::now();
+
+        if (counters != nullptr) result.counter_samples.push_back(counters->stop());
+        if (aoc::alloc::enabled()) result.alloc_samples.push_back(allocs.totals());
+
+        result.samples_ns.push_back(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(stop - start).count());
+
+        if constexpr (std::is_same_v<decltype(value), std::string>) { result.answer = std::move(value); }
+    }
+
+    return result;
+}
+
+// Nearest-rank percentile of sorted samples: the smallest sample with at least p percent of the
+// samples at or below it.
+int64_t percentile(const std::vector<int64_t>& sorted, double p)
+{
+    auto rank = static_cast<std::size_t>(std::ceil(p / 100.0 * static_cast<double>(sorted.size())));
+    return sorted[std::clamp<std::size_t>(rank, 1, sorted.size()) - 1];
+}
+
+std::string join(const std::vector<std::string>& items, std::string_view separator)
+{
+    std::string joined;
+
+    for (const auto& item : items) {
+        if (!joined.empty()) joined += separator;
+        joined += item;
+    }
+
+    return joined;
+}
+
+// Median of every hardware counter that produced a reading, e.g. {"cycles": 1234, ...}.
+std::string counters_json(const std::vector<aoc::perf_sample>& samples)
+{
+    std::vector<std::string> entries;
+
+    for (std::size_t i = 0; i < aoc::perf_counter_names.size(); ++i) {
+        std::vector<int64_t> values;
+
+        for (const auto& sample : samples) {
+            if (sample[i]) values.push_back(*sample[i]);
+        }
+
+        if (values.empty()) continue;
+
+        std::sort(values.begin(), values.end());
+        entries.push_back(
+            fmt::format("\"{}\": {}", aoc::perf_counter_names[i], percentile(values, 50)));
+    }
+
+    return fmt::format("{{{}}}", join(entries, ", "));
+}
+
+std::string allocations_json(const std::vector<aoc::alloc::stats>& samples)
+{
+    auto median = [&samples](auto member) {
+        std::vector<int64_t> values;
+
+        for (const auto& sample : samples) {
+            values.push_back(sample.*member);
+        }
+
+        std::sort(values.begin(), values.end());
+        return percentile(values, 50);
+    };
+
+    return fmt::format(
+        R"({{"count": {}, "bytes": {}, "peak_live_bytes": {}}})",
+        median(&aoc::alloc::stats::count),
+        median(&aoc::alloc::stats::bytes),
+        median(&aoc::alloc::stats::peak_live_bytes));
+}
+
+std::string phase_json(const phase_result& phase)
+{
+    auto sorted = phase.samples_ns;
+    std::sort(sorted.begin(), sorted.end());
+
+    auto mean = std::accumulate(sorted.begin(), sorted.end(), int64_t{0})
+                / static_cast<int64_t>(sorted.size());
+
+    auto counters = phase.counter_samples.empty()
+                        ? std::string{}
+                        : fmt::format(", \"counters\": {}", counters_json(phase.counter_samples));
+
+    auto allocations = phase.alloc_samples.empty()
+                           ? std::string{}
+                           : fmt::format(", \"allocations\": {}", allocations_json(phase.alloc_samples));
+
+    return fmt::format(
+        R"({{"name": "{}", "answer": "{}", "runs": {}, "min_ns": {}, "median_ns": {}, "p99_ns": {}, )"
+        R"("mean_ns": {}, "max_ns": {}{}{}}})",
+        phase.name,
+        aoc::json_escape(phase.answer),
+        sorted.size(),
+        sorted.front(),
+        percentile(sorted, 50),
+        percentile(sorted, 99),
+        mean,
+        sorted.back(),
+        counters,
+        allocations);
+}
+
+// scale is only set for generated inputs and is reported alongside the day.
+std::string bench_day(
+    const aoc::day_solution&     solution,
+    const std::filesystem::path& input_path,
+    std::optional<int64_t>       scale,
+    const options&               opts,
+    aoc::perf_counters*          counters)
+{
+    std::vector<phase_result> phases;
+
+    phases.push_back(measure("parse", opts, counters, [&] { return solution.parse(input_path); }));
+
+    auto input = solution.parse(input_path);
+
+    for (std::size_t part = 0; part < solution.parts.size(); ++part) {
+        phases.push_back(measure(fmt::format("part{}", part + 1), opts, counters, [&] {
+            return solution.parts[part](input);
+        }));
+    }
+
+    std::vector<std::string> entries;
+    for (const auto& phase : phases) {
+        entries.push_back(phase_json(phase));
+    }
+
+    return fmt::format(
+        "    {{\"day\": {}{}, \"phases\": [\n      {}]}}",
+        solution.day,
+        scale ? fmt::format(", \"scale\": {}", *scale) : std::string{},
+        join(entries, ",\n      "));
+}
+
+// Removes the file at path when it goes out of scope, also when a benchmark throws.
+struct temp_file {
+    std::filesystem::path path;
+
+    explicit temp_file(std::filesystem::path p)
+        : path{std::move(p)}
+    {
+    }
+
+    temp_file(const temp_file&) = delete;
+    temp_file& operator=(const temp_file&) = delete;
+
+    ~temp_file()
+    {
+        std::error_code error;
+        std::filesystem::remove(path, error);
+    }
+};
+
+long process_id()
+{
+#ifdef _WIN32
+    return static_cast<long>(_getpid());
+#else
+    return static_cast<long>(getpid());
+#endif
+}
+
+// Writes the day's generated input at the given scale to a temporary file and benchmarks it.
+std::string bench_generated(
+    const aoc::day_solution& solution,
+    int64_t                  scale,
+    const options&           opts,
+    aoc::perf_counters*      counters)
+{
+    const auto* generator = aoc::find_generator(solution.day);
+
+    if (generator == nullptr) {
+        throw std::invalid_argument{fmt::format("Day {} has no input generator", solution.day)};
+    }
+
+    if (scale < generator->min_scale || scale > generator->max_scale) {
+        throw std::invalid_argument{fmt::format(
+            "Day {} scale ({}) must be between {} and {}",
+            solution.day,
+            generator->scale,
+            generator->min_scale,
+            generator->max_scale)};
+    }
+
+    fmt::memory_buffer buffer;
+    generator->generate(buffer, scale, opts.seed);
+
+    // The process id keeps concurrent bench runs from sharing a file.
+    temp_file input{
+        std::filesystem::temp_directory_path()
+        / fmt::format("aoc2020_day{:02}_{}_{}.in", solution.day, scale, process_id())};
+
+    std::FILE* file = std::fopen(input.path.string().c_str(), "wb");
+
+    if (file == nullptr) {
+        throw std::runtime_error{fmt::format("Unable to write {}", input.path.string())};
+    }
+
+    auto written = std::fwrite(buffer.data(), 1, buffer.size(), file);
+
+    if (std::fclose(file) != 0 || written != buffer.size()) {
+        throw std::runtime_error{fmt::format("Unable to write {}", input.path.string())};
+    }
+
+    return bench_day(solution, input.path, scale, opts, counters);
+}
+
+options parse_options(int argc, char* argv[])
+{
+    options opts;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string_view arg{argv[i]};
+        bool             has_value = i + 1 < argc;
+
+        if (arg == "--days" && has_value) { opts.days = aoc::parse_list<int>(argv[++i]); }
+        else if (arg == "--warmup" && has_value) {
+            opts.warmup = std::stoi(argv[++i]);
+        }
+        else if (arg == "--runs" && has_value) {
+            opts.runs = std::stoi(argv[++i]);
+        }
+        else if (arg == "--output" && has_value) {
+            opts.output = argv[++i];
+        }
+        else if (arg == "--scales" && has_value) {
+            opts.scales = aoc::parse_list<int64_t>(argv[++i]);
+        }
+        else if (arg == "--seed" && has_value) {
+            opts.seed = std::stoull(argv[++i]);
+        }
+        else if (arg == "--counters") {
+            opts.counters = true;
+        }
+        else if (arg == "--trace" && has_value) {
+            if (!aoc::trace::enabled) fmt::print(stderr, "--trace needs a build with AOC2020_TRACE\n");
+            aoc::trace::write_timeline(argv[++i]);
+        }
+        else {
+            throw std::invalid_argument{fmt::format(
+                "usage: {} [--days N[,N...]] [--warmup N] [--runs N] [--output FILE] [--counters] "
+                "[--trace FILE] [--scales N[,N...]] [--seed N]",
+                argv[0])};
+        }
+    }
+
+    if (opts.runs < 1) throw std::invalid_argument{"--runs must be at least 1"};
+
+    if (opts.days.empty()) {
+        for (const auto& solution : aoc::registered_days()) {
+            opts.days.push_back(solution.day);
+        }
+    }
+
+    return opts;
+}
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    try {
+        auto opts = parse_options(argc, argv);
+
+        std::optional<aoc::perf_counters> counters;
+
+        if (opts.counters) {
+            counters.emplace();
+
+            if (!counters->available()) {
+                fmt::print(stderr, "Hardware counters are not available, reporting wall time only\n");
+                counters.reset();
+            }
+            else {
+                fmt::print(stderr, "Hardware counters cover the benchmarking thread only\n");
+            }
+        }
+
+        std::vector<std::string> days;
+
+        for (int day : opts.days) {
+            const auto* solution = aoc::find_day(day);
+
+            if (solution == nullptr) {
+                fmt::print(stderr, "Day {} is not part of this build\n", day);
+                return 1;
+            }
+
+            auto* day_counters = counters ? &*counters : nullptr;
+
+            if (opts.scales.empty()) {
+                auto input_path = aoc::default_input_path(day);
+
+                fmt::print(stderr, "Benchmarking day {:02}\n", day);
+                days.push_back(bench_day(*solution, input_path, std::nullopt, opts, day_counters));
+            }
+
+            for (auto scale : opts.scales) {
+                fmt::print(stderr, "Benchmarking day {:02} at scale {}\n", day, scale);
+                days.push_back(bench_generated(*solution, scale, opts, day_counters));
+            }
+        }
+
+        std::FILE* out = opts.output.empty() ? stdout : std::fopen(opts.output.c_str(), "w");
+
+        if (out == nullptr) {
+            fmt::print(stderr, "Unable to open {}\n", opts.output);
+            return 1;
+        }
+
+        // Counters only follow the benchmarking thread; work a part hands to a pool is not included.
+        auto counter_scope = counters ? std::string{"\n  \"counters_scope\": \"calling thread\","}
+                                      : std::string{};
+
+        fmt::print(
+            out,
+            "{{\n  \"warmup\": {},\n  \"runs\": {},{}\n  \"days\": [\n{}\n  ]\n}}\n",
+            opts.warmup,
+            opts.runs,
+            counter_scope,
+            join(days, ",\n"));
+
+        if (out != stdout) std::fclose(out);
+    }
+    catch (const std::exception& e) {
+        fmt::print(stderr, "{}\n", e.what());
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,121 @@
+#include <aoc2020/generators.hpp>
+
+#include <fmt/core.h>
+
+#include <cstdint>
+#include <cstdio>
+#include <exception>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+
+namespace {
+
+struct options {
+    int                    day = 0;
+    std::optional<int64_t> scale;
+    uint64_t               seed = 2020;
+    std::string            output;
+    bool                   list = false;
+};
+
+options parse_options(int argc, char* argv[])
+{
+    options opts;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string_view arg{argv[i]};
+        bool             has_value = i + 1 < argc;
+
+        if (arg == "--day" && has_value) { opts.day = std::stoi(argv[++i]); }
+        else if (arg == "--scale" && has_value) {
+            opts.scale = std::stoll(argv[++i]);
+        }
+        else if (arg == "--seed" && has_value) {
+            opts.seed = std::stoull(argv[++i]);
+        }
+        else if (arg == "--output" && has_value) {
+            opts.output = argv[++i];
+        }
+        else if (arg == "--list") {
+            opts.list = true;
+        }
+        else {
+            throw std::invalid_argument{fmt::format(
+                "usage: {} --day N [--scale N] [--seed N] [--output FILE]\n       {} --list",
+                argv[0],
+                argv[0])};
+        }
+    }
+
+    if (!opts.list && opts.day == 0) throw std::invalid_argument{"--day is required"};
+
+    return opts;
+}
+
+void print_generators()
+{
+    fmt::print("{:>3}  {:<20} {:>10} {:>10} {:>10}\n", "day", "scale", "default", "min", "max");
+
+    for (const auto& g : aoc::input_generators()) {
+        fmt::print(
+            "{:>3}  {:<20} {:>10} {:>10} {:>10}\n",
+            g.day,
+            g.scale,
+            g.default_scale,
+            g.min_scale,
+            g.max_scale);
+    }
+}
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    try {
+        auto opts = parse_options(argc, argv);
+
+        if (opts.list) {
+            print_generators();
+            return 0;
+        }
+
+        const auto* generator = aoc::find_generator(opts.day);
+
+        if (generator == nullptr) {
+            throw std::invalid_argument{fmt::format("Day {} has no input generator", opts.day)};
+        }
+
+        auto scale = opts.scale.value_or(generator->default_scale);
+
+        if (scale < generator->min_scale || scale > generator->max_scale) {
+            throw std::invalid_argument{fmt::format(
+                "Day {} scale ({}) must be between {} and {}",
+                opts.day,
+                generator->scale,
+                generator->min_scale,
+                generator->max_scale)};
+        }
+
+        fmt::memory_buffer buffer;
+        generator->generate(buffer, scale, opts.seed);
+
+        std::FILE* out = opts.output.empty() ? stdout : std::fopen(opts.output.c_str(), "wb");
+
+        if (out == nullptr) {
+            fmt::print(stderr, "Unable to open {}\n", opts.output);
+            return 1;
+        }
+
+        std::fwrite(buffer.data(), 1, buffer.size(), out);
+
+        if (out != stdout) std::fclose(out);
+    }
+    catch (const std::exception& e) {
+        fmt::print(stderr, "{}\n", e.what());
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,1251 @@
+#include "generators.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdlib>
+#include <iterator>
+#include <numeric>
+#include <optional>
+#include <random>
+#include <set>
+#include <span>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace aoc {
+
+namespace {
+
+    // The output of std::mt19937_64 is fixed by the standard but the distributions are not, so every
+    // draw is derived from the raw engine output to keep inputs identical across toolchains.
+    class random_source {
+    public:
+        explicit random_source(uint64_t seed)
+            : engine_{seed}
+        {
+        }
+
+        // Uniform in [lo, hi].
+        int64_t between(int64_t lo, int64_t hi)
+        {
+            return lo + static_cast<int64_t>(engine_() % static_cast<uint64_t>(hi - lo + 1));
+        }
+
+        std::size_t index(std::size_t size)
+        {
+            return static_cast<std::size_t>(engine_() % size);
+        }
+
+        bool chance(double p) { return static_cast<double>(engine_() >> 11) * 0x1.0p-53 < p; }
+
+        char letter() { return static_cast<char>('a' + between(0, 25)); }
+
+        template <typename Container>
+        const auto& pick(const Container& items)
+        {
+            return items[index(std::size(items))];
+        }
+
+        template <typename Container>
+        void shuffle(Container& items)
+        {
+            for (auto n = std::size(items); n > 1; --n) {
+                std::swap(items[n - 1], items[index(n)]);
+            }
+        }
+
+    private:
+        std::mt19937_64 engine_;
+    };
+
+    using buffer = fmt::memory_buffer;
+
+    std::string join(const std::vector<std::string>& items, std::string_view separator)
+    {
+        std::string joined;
+
+        for (const auto& item : items) {
+            if (!joined.empty()) joined += separator;
+            joined += item;
+        }
+
+        return joined;
+    }
+
+    // Expense report: exactly one pair and one triple sum to 2020. Every other entry is above 1010, so
+    // no two of them can, and entries that would complete a pair or triple with planted values are
+    // redrawn.
+    void generate_day01(buffer& out, int64_t scale, uint64_t seed)
+    {
+        random_source rng{seed};
+
+        std::vector<int64_t> entries;
+        int                  pairs   = 0;
+        int                  triples = 0;
+
+        while (pairs != 1 || triples != 1) {
+            auto pair     = rng.between(20, 1000);
+            auto triple_a = rng.between(20, 600);
+            auto triple_b = rng.between(20, 600);
+
+            entries = {pair, 2020 - pair, triple_a, triple_b, 2020 - triple_a - triple_b};
+            pairs   = 0;
+            triples = 0;
+
+            for (std::size_t i = 0; i < entries.size(); ++i) {
+                for (std::size_t j = i + 1; j < entries.size(); ++j) {
+                    if (entries[i] + entries[j] == 2020) ++pairs;
+
+                    for (std::size_t k = j + 1; k < entries.size(); ++k) {
+                        if (entries[i] + entries[j] + entries[k] == 2020) ++triples;
+                    }
+                }
+            }
+        }
+
+        std::set<int64_t> completing;
+        for (std::size_t i = 0; i < entries.size(); ++i) {
+            completing.insert(2020 - entries[i]);
+
+            for (std::size_t j = i + 1; j < entries.size(); ++j) {
+                completing.insert(2020 - entries[i] - entries[j]);
+            }
+        }
+
+        while (std::ssize(entries) < scale) {
+            auto filler = rng.between(1011, 2019);
+            if (!completing.contains(filler)) entries.push_back(filler);
+        }
+
+        rng.shuffle(entries);
+
+        for (auto entry : entries) {
+            fmt::format_to(std::back_inserter(out), "{}\n", entry);
+        }
+    }
+
+    // Password policies; every password is at least as long as the policy's upper position.
+    void generate_day02(buffer& out, int64_t scale, uint64_t seed)
+    {
+        random_source rng{seed};
+
+        for (int64_t line = 0; line < scale; ++line) {
+            auto target = rng.letter();
+            auto low    = rng.between(1, 8);
+            auto high   = rng.between(low + 1, 16);
+            auto length = rng.between(high, high + 6);
+
+            std::string password;
+            for (int64_t i = 0; i < length; ++i) {
+                password += rng.chance(0.3) ? target : rng.letter();
+            }
+
+            fmt::format_to(std::back_inserter(out), "{}-{} {}: {}\n", low, high, target, password);
+        }
+    }
+
+    // Tree map, 31 columns wide like the puzzle.
+    void generate_day03(buffer& out, int64_t scale, uint64_t seed)
+    {
+        random_source rng{seed};
+
+        for (int64_t row = 0; row < scale; ++row) {
+            for (int column = 0; column < 31; ++column) {
+                out.push_back((row | column) != 0 && rng.chance(0.2) ? '#' : '.');
+            }
+            out.push_back('\n');
+        }
+    }
+
+    // Passports with missing fields and out-of-range values. Every value still parses the way the
+    // part 2 rules expect (years and heights are numeric).
+    void generate_day04(buffer& out, int64_t scale, uint64_t seed)
+    {
+        random_source rng{seed};
+
+        constexpr std::array<std::string_view, 8> tags{
+            "byr", "iyr", "eyr", "hgt", "hcl", "ecl", "pid", "cid"};
+        constexpr std::array<std::string_view, 7> eye_colors{
+            "amb", "blu", "brn", "gry", "grn", "hzl", "oth"};
+        constexpr std::array<std::string_view, 4> bad_eye_colors{"xry", "zzz", "gmt", "lzr"};
+
+        auto year = [&rng](int64_t low, int64_t high, bool valid) {
+            if (valid) return rng.between(low, high);
+            return rng.chance(0.5) ? rng.between(low - 20, low - 1) : rng.between(high + 1, high + 10);
+        };
+
+        auto digits = [&rng](int64_t count) {
+            std::string s;
+            for (int64_t i = 0; i < count; ++i) {
+                s += static_cast<char>('0' + rng.between(0, 9));
+            }
+            return s;
+        };
+
+        auto hex = [&rng](char alphabet_end) {
+            std::string s;
+            for (int i = 0; i < 6; ++i) {
+                auto c = rng.between(0, 9 + alphabet_end - 'a' + 1);
+                s += static_cast<char>(c < 10 ? '0' + c : 'a' + c - 10);
+            }
+            return s;
+        };
+
+        auto value = [&](std::string_view tag, bool valid) -> std::string {
+            if (tag == "byr") return fmt::format("{}", year(1920, 2002, valid));
+            if (tag == "iyr") return fmt::format("{}", year(2010, 2020, valid));
+            if (tag == "eyr") return fmt::format("{}", year(2020, 2030, valid));
+            if (tag == "hgt") {
+                if (valid) {
+                    return rng.chance(0.5) ? fmt::format("{}cm", rng.between(150, 193))
+                                           : fmt::format("{}in", rng.between(59, 76));
+                }
+                return rng.chance(0.5) ? fmt::format("{}", rng.between(50, 200))
+                                       : fmt::format("{}cm", rng.between(100, 149));
+            }
+            if (tag == "hcl") {
+                if (valid) return "#" + hex('f');
+                return rng.chance(0.5) ? hex('f') : "#" + hex('z');
+            }
+            if (tag == "ecl") {
+                return std::string{valid ? rng.pick(eye_colors) : rng.pick(bad_eye_colors)};
+            }
+            if (tag == "pid") return digits(valid ? 9 : rng.pick(std::array{8, 10}));
+            return fmt::format("{}", rng.between(100, 350));
+        };
+
+        for (int64_t passport = 0; passport < scale; ++passport) {
+            std::vector<std::string> fields;
+
+            for (auto tag : tags) {
+                if (rng.chance(tag == "cid" ? 0.5 : 0.92)) {
+                    fields.push_back(fmt::format("{}:{}", tag, value(tag, rng.chance(0.85))));
+                }
+            }
+
+            rng.shuffle(fields);
+
+            for (std::size_t i = 0; i < fields.size(); ++i) {
+                bool last = i + 1 == fields.size();
+                auto separator = last || rng.chance(0.3) ? '\n' : ' ';
+                fmt::format_to(std::back_inserter(out), "{}{}", fields[i], separator);
+            }
+
+            out.push_back('\n');
+        }
+    }
+
+    // Boarding passes for a contiguous block of seats with one gap. There are only 1024 seat ids.
+    void generate_day05(buffer& out, int64_t scale, uint64_t seed)
+    {
+        random_source rng{seed};
+
+        auto first   = rng.between(0, 1023 - scale);
+        auto missing = rng.between(first + 1, first + scale - 1);
+
+        std::vector<int64_t> seats;
+        for (auto id = first; id <= first + scale; ++id) {
+            if (id != missing) seats.push_back(id);
+        }
+
+        rng.shuffle(seats);
+
+        for (auto id : seats) {
+            for (int bit = 9; bit >= 0; --bit) {
+                bool set = ((id >> bit) & 1) != 0;
+                out.push_back(bit >= 3 ? (set ? 'B' : 'F') : (set ? 'R' : 'L'));
+            }
+            out.push_back('\n');
+        }
+    }
+
+    // Customs answers, blank-line separated groups of one to five people.
+    void generate_day06(buffer& out, int64_t scale, uint64_t seed)
+    {
+        random_source rng{seed};
+
+        for (int64_t group = 0; group < scale; ++group) {
+            std::string shared;
+            for (char c = 'a'; c <= 'z'; ++c) {
+                if (rng.chance(0.25)) shared += c;
+            }
+
+            auto people = rng.between(1, 5);
+
+            for (int64_t person = 0; person < people; ++person) {
+                auto answers = shared;
+                for (char c = 'a'; c <= 'z'; ++c) {
+                    if (answers.find(c) == std::string::npos && rng.chance(0.1)) answers += c;
+                }
+
+                if (answers.empty()) answers += rng.letter();
+
+                rng.shuffle(answers);
+                fmt::format_to(std::back_inserter(out), "{}\n", answers);
+            }
+
+            out.push_back('\n');
+        }
+    }
+
+    // Bag rules forming an eight layer DAG; bags only contain bags from the next layer, so the
+    // nesting depth (and the part 2 total) stays bounded at any scale. "shiny gold" sits in layer 3
+    // with at least one parent and one child.
+    void generate_day07(buffer& out, int64_t scale, uint64_t seed)
+    {
+        random_source rng{seed};
+
+        constexpr std::array<std::string_view, 18> adjectives{
+            "bright", "clear", "dark",  "dim",   "dotted", "drab",    "dull",    "faded",   "light",
+            "mirrored", "muted", "pale", "plaid", "posh",  "shiny",   "striped", "vibrant", "wavy"};
+        constexpr std::array<std::string_view, 33> colors{
+            "aqua",    "beige",   "black",  "blue",   "bronze",    "brown",  "chartreuse",
+            "coral",   "crimson", "cyan",   "fuchsia", "gold",     "gray",   "green",
+            "indigo",  "lavender", "lime",  "magenta", "maroon",   "olive",  "orange",
+            "plum",    "purple",  "red",    "salmon", "silver",    "tan",    "teal",
+            "tomato",  "turquoise", "violet", "white", "yellow"};
+
+        constexpr auto combinations = static_cast<int64_t>(adjectives.size() * colors.size());
+        constexpr int  layers       = 8;
+
+        std::vector<std::string> names;
+
+        for (int64_t i = 0; i < scale; ++i) {
+            std::string suffix;
+            for (auto block = i / combinations; block > 0; block = (block - 1) / 26) {
+                suffix += static_cast<char>('a' + (block - 1) % 26);
+            }
+
+            auto combination = static_cast<std::size_t>(i % combinations);
+            names.push_back(fmt::format(
+                "{}{} {}",
+                adjectives[combination % adjectives.size()],
+                suffix,
+                colors[combination / adjectives.size()]));
+        }
+
+        rng.shuffle(names);
+
+        auto layer_start = [scale](int64_t layer) { return (layer * scale + layers - 1) / layers; };
+
+        auto gold     = layer_start(3);
+        auto existing = std::find(names.begin(), names.end(), "shiny gold");
+        if (existing != names.end()) std::iter_swap(existing, names.begin() + gold);
+        names[static_cast<std::size_t>(gold)] = "shiny gold";
+
+        std::vector<std::vector<std::pair<int64_t, int64_t>>> contents(names.size());
+
+        auto add_child = [&](int64_t parent, int64_t child) {
+            auto& children = contents[static_cast<std::size_t>(parent)];
+            auto present = [child](const auto& c) { return c.first == child; };
+
+            if (std::none_of(children.begin(), children.end(), present)) {
+                children.emplace_back(child, rng.between(1, 5));
+            }
+        };
+
+        for (int64_t layer = 0; layer + 1 < layers; ++layer) {
+            auto next_first = layer_start(layer + 1);
+            auto next_last  = layer_start(layer + 2) - 1;
+
+            for (auto bag = layer_start(layer); bag < next_first; ++bag) {
+                auto children = rng.between(bag == gold ? 1 : 0, 4);
+
+                for (int64_t i = 0; i < children; ++i) {
+                    add_child(bag, rng.between(next_first, next_last));
+                }
+            }
+        }
+
+        add_child(rng.between(layer_start(2), gold - 1), gold);
+
+        std::vector<std::string> rules;
+
+        for (std::size_t bag = 0; bag < names.size(); ++bag) {
+            std::vector<std::string> children;
+
+            for (auto [child, count] : contents[bag]) {
+                children.push_back(fmt::format(
+                    "{} {} bag{}",
+                    count,
+                    names[static_cast<std::size_t>(child)],
+                    count > 1 ? "s" : ""));
+            }
+
+            rules.push_back(fmt::format(
+                "{} bags contain {}.",
+                names[bag],
+                children.empty() ? "no other bags" : join(children, ", ")));
+        }
+
+        rng.shuffle(rules);
+
+        for (const auto& rule : rules) {
+            fmt::format_to(std::back_inserter(out), "{}\n", rule);
+        }
+    }
+
+    // Boot code that loops through a jmp back at position m. Everything before m only falls
+    // through, jumps forward to at most m, or is a nop whose target is at most m, so flipping any of
+    // those still ends up at m. Flipping the jmp at m is the one repair that reaches the end.
+    void generate_day08(buffer& out, int64_t scale, uint64_t seed)
+    {
+        random_source rng{seed};
+
+        std::vector<std::pair<std::string_view, int64_t>> program(static_cast<std::size_t>(scale));
+
+        auto m = rng.between(scale / 2, scale - 2);
+
+        auto set = [&program](int64_t at, std::string_view op, int64_t amount) {
+            program[static_cast<std::size_t>(at)] = {op, amount};
+        };
+
+        auto fall_through = [&](int64_t at, int64_t last_target) {
+            if (rng.chance(0.6)) set(at, "acc", rng.between(-50, 50));
+            else
+                set(at, "nop", rng.between(-at, last_target - at));
+        };
+
+        for (int64_t at = 0; at < m;) {
+            if (m - at > 1 && rng.chance(0.25)) {
+                auto skip = rng.between(2, std::min<int64_t>(6, m - at));
+
+                set(at, "jmp", skip);
+                for (auto skipped = at + 1; skipped < at + skip; ++skipped) {
+                    fall_through(skipped, m);
+                }
+
+                at += skip;
+            }
+            else {
+                fall_through(at++, m);
+            }
+        }
+
+        set(m, "jmp", -rng.between(1, m));
+
+        for (auto at = m + 1; at < scale; ++at) {
+            if (rng.chance(0.2)) set(at, "jmp", rng.between(1, std::min<int64_t>(6, scale - at)));
+            else
+                fall_through(at, scale);
+        }
+
+        for (auto [op, amount] : program) {
+            fmt::format_to(std::back_inserter(out), "{} {:+}\n", op, amount);
+        }
+    }
+
+    // XMAS data: after the 25-number preamble every value is the sum of two of the previous 25,
+    // except one, which instead equals the sum of a contiguous run earlier in the list. Values may be
+    // negative, which keeps them within about 2^31 at any scale.
+    void generate_day09(buffer& out, int64_t scale, uint64_t seed)
+    {
+        random_source rng{seed};
+
+        constexpr int64_t preamble = 25;
+
+        std::vector<int64_t> values;
+
+        while (std::ssize(values) < preamble) {
+            auto v = rng.between(-1000000, 1000000);
+            if (v != 0) values.push_back(v);
+        }
+
+        auto is_sum_of_window = [&values](int64_t x) {
+            auto window = std::span{values}.last(preamble);
+            return std::any_of(window.begin(), window.end(), [&window, x](int64_t w) {
+                return std::find(window.begin(), window.end(), x - w) != window.end();
+            });
+        };
+
+        auto invalid_at = rng.between(std::max(preamble, scale / 2), scale - 1);
+
+        for (auto at = preamble; at < scale; ++at) {
+            if (at == invalid_at) {
+                while (true) {
+                    auto start  = rng.between(0, at - 3);
+                    auto length = rng.between(2, std::min<int64_t>(17, at - start));
+                    auto first  = values.begin() + start;
+                    auto x      = std::accumulate(first, first + length, int64_t{0});
+
+                    if (x != 0 && !is_sum_of_window(x)) {
+                        values.push_back(x);
+                        break;
+                    }
+                }
+                continue;
+            }
+
+            // The pair sum closest to a random target keeps values spread over both signs instead
+            // of compounding towards overflow.
+            auto window = std::span{values}.last(preamble);
+            auto target = rng.between(-(int64_t{1} << 30), int64_t{1} << 30);
+
+            std::optional<int64_t> next;
+
+            for (std::size_t a = 0; a < window.size(); ++a) {
+                for (std::size_t b = a + 1; b < window.size(); ++b) {
+                    auto sum = window[a] + window[b];
+                    if (sum == 0) continue;
+                    if (!next || std::abs(sum - target) < std::abs(*next - target)) next = sum;
+                }
+            }
+
+            values.push_back(*next);
+        }
+
+        for (auto v : values) {
+            fmt::format_to(std::back_inserter(out), "{}\n", v);
+        }
+    }
+
+    // Adapter ratings, sorted steps of 1 and 3 with runs of at most four 1-steps (the only ones the
+    // solver's arrangement table knows). Long runs stop once the part 2 product nears 2^60.
+    void generate_day10(buffer& out, int64_t scale, uint64_t seed)
+    {
+        random_source rng{seed};
+
+        static constexpr std::array<double, 5> log2_arrangements{0, 0, 1, 2, 2.807};
+
+        std::vector<int64_t> ratings;
+        int64_t              rating = 0;
+        double               budget = 60;
+
+        while (std::ssize(ratings) < scale) {
+            auto run = rng.between(0, 4);
+
+            auto cost = [&run] { return log2_arrangements[static_cast<std::size_t>(run)]; };
+
+            if (cost() > budget) run = std::min<int64_t>(run, 1);
+            budget -= cost();
+
+            for (int64_t i = 0; i < run && std::ssize(ratings) < scale; ++i) {
+                ratings.push_back(++rating);
+            }
+
+            rating += 3;
+            if (std::ssize(ratings) < scale) ratings.push_back(rating);
+        }
+
+        rng.shuffle(ratings);
+
+        for (auto r : ratings) {
+            fmt::format_to(std::back_inserter(out), "{}\n", r);
+        }
+    }
+
+    // Square seat layout.
+    void generate_day11(buffer& out, int64_t scale, uint64_t seed)
+    {
+        random_source rng{seed};
+
+        for (int64_t row = 0; row < scale; ++row) {
+            for (int64_t column = 0; column < scale; ++column) {
+                out.push_back(rng.chance(0.75) ? 'L' : '.');
+            }
+            out.push_back('\n');
+        }
+    }
+
+    // Navigation instructions. Cardinal moves are kept short so the part 2 waypoint, and with it
+    // the ship's distance, stays within int at large scales.
+    void generate_day12(buffer& out, int64_t scale, uint64_t seed)
+    {
+        random_source rng{seed};
+
+        for (int64_t line = 0; line < scale; ++line) {
+            auto kind = rng.between(0, 9);
+
+            if (kind < 3) { fmt::format_to(std::back_inserter(out), "F{}\n", rng.between(1, 100)); }
+            else if (kind < 7) {
+                auto direction = rng.pick(std::string_view{"NESW"});
+                fmt::format_to(std::back_inserter(out), "{}{}\n", direction, rng.between(1, 5));
+            }
+            else {
+                fmt::format_to(
+                    std::back_inserter(out),
+                    "{}{}\n",
+                    rng.chance(0.5) ? 'L' : 'R',
+                    90 * rng.between(1, 3));
+            }
+        }
+    }
+
+    // Bus schedule with scale slots. Bus ids are distinct primes whose product stays below 2^53,
+    // so the part 2 timestamp fits in int64_t however long the schedule is.
+    void generate_day13(buffer& out, int64_t scale, uint64_t seed)
+    {
+        random_source rng{seed};
+
+        auto is_prime = [](int64_t n) {
+            for (int64_t d = 2; d * d <= n; ++d) {
+                if (n % d == 0) return false;
+            }
+            return true;
+        };
+
+        std::vector<int64_t> small_primes;
+        std::vector<int64_t> large_primes;
+
+        for (int64_t n = 13; n < 1000; ++n) {
+            if (!is_prime(n)) continue;
+            if (n < 64) small_primes.push_back(n);
+            else if (n > 400)
+                large_primes.push_back(n);
+        }
+
+        rng.shuffle(small_primes);
+        rng.shuffle(large_primes);
+
+        std::vector<int64_t> buses{large_primes[0], large_primes[1]};
+        int64_t              product = buses[0] * buses[1];
+
+        for (auto p : small_primes) {
+            if (std::ssize(buses) == 9 || product > (int64_t{1} << 53) / p) break;
+
+            buses.push_back(p);
+            product *= p;
+        }
+
+        rng.shuffle(buses);
+
+        std::vector<int64_t> slots(static_cast<std::size_t>(scale), 0);
+        slots[0] = buses[0];
+
+        for (std::size_t i = 1; i < buses.size(); ++i) {
+            std::size_t slot;
+            do {
+                slot = rng.index(slots.size());
+            } while (slots[slot] != 0);
+
+            slots[slot] = buses[i];
+        }
+
+        std::vector<std::string> schedule;
+        for (auto bus : slots) {
+            schedule.push_back(bus == 0 ? "x" : fmt::format("{}", bus));
+        }
+
+        auto earliest_departure = rng.between(1000000, 1010000);
+        fmt::format_to(std::back_inserter(out), "{}\n{}\n", earliest_departure, join(schedule, ","));
+    }
+
+    // Docking program of scale lines. Masks float 3 to 9 bits, as in the puzzle, to bound the
+    // number of part 2 addresses per write.
+    void generate_day14(buffer& out, int64_t scale, uint64_t seed)
+    {
+        random_source rng{seed};
+
+        for (int64_t line = 0; line < scale;) {
+            std::string mask(36, '0');
+            for (auto& bit : mask) {
+                bit = rng.chance(0.5) ? '1' : '0';
+            }
+
+            for (auto floating = rng.between(3, 9); floating > 0;) {
+                auto& bit = mask[rng.index(mask.size())];
+                if (bit != 'X') {
+                    bit = 'X';
+                    --floating;
+                }
+            }
+
+            fmt::format_to(std::back_inserter(out), "mask = {}\n", mask);
+            ++line;
+
+            for (auto writes = rng.between(1, 6); writes > 0 && line < scale; --writes, ++line) {
+                fmt::format_to(
+                    std::back_inserter(out),
+                    "mem[{}] = {}\n",
+                    rng.between(0, 65535),
+                    rng.between(0, (int64_t{1} << 30) - 1));
+            }
+        }
+    }
+
+    // Distinct starting numbers for the memory game.
+    void generate_day15(buffer& out, int64_t scale, uint64_t seed)
+    {
+        random_source rng{seed};
+
+        std::vector<std::string> numbers;
+        for (int64_t n = 0; n <= 3 * scale; ++n) {
+            numbers.push_back(fmt::format("{}", n));
+        }
+
+        rng.shuffle(numbers);
+        numbers.resize(static_cast<std::size_t>(scale));
+
+        fmt::format_to(std::back_inserter(out), "{}\n", join(numbers, ","));
+    }
+
+    // Ticket notes with scale nearby tickets. Rule r accepts everything except band r
+    // ([50 + 20r, 69 + 20r]); the field ranked r only ever holds values from lower bands or outside
+    // all bands, and holds at least one value from every lower band. Column r therefore matches
+    // exactly the rules ranked r and above, which is what the elimination in part 2 needs.
+    void generate_day16(buffer& out, int64_t scale, uint64_t seed)
+    {
+        random_source rng{seed};
+
+        constexpr std::array<std::string_view, 20> names{
+            "departure location", "departure station", "departure platform", "departure track",
+            "departure date",     "departure time",    "arrival location",   "arrival station",
+            "arrival platform",   "arrival track",     "class",              "duration",
+            "price",              "route",             "row",                "seat",
+            "train",              "type",              "wagon",              "zone"};
+
+        constexpr int64_t fields = names.size();
+
+        auto band_value = [&rng](int64_t band) { return rng.between(50 + 20 * band, 69 + 20 * band); };
+        auto free_value = [&rng] {
+            return rng.chance(0.1) ? rng.between(25, 49) : rng.between(450, 974);
+        };
+
+        std::vector<int64_t> rank_of_rule(fields);
+        std::vector<int64_t> column_of_rank(fields);
+        for (int64_t i = 0; i < fields; ++i) {
+            rank_of_rule[static_cast<std::size_t>(i)]   = i;
+            column_of_rank[static_cast<std::size_t>(i)] = i;
+        }
+        rng.shuffle(rank_of_rule);
+        rng.shuffle(column_of_rank);
+
+        for (std::size_t rule = 0; rule < names.size(); ++rule) {
+            auto rank = rank_of_rule[rule];
+            fmt::format_to(
+                std::back_inserter(out),
+                "{}: 25-{} or {}-974\n",
+                names[rule],
+                49 + 20 * rank,
+                70 + 20 * rank);
+        }
+
+        auto ticket_line = [&](const std::vector<int64_t>& values) {
+            std::vector<std::string> text;
+            for (auto v : values) {
+                text.push_back(fmt::format("{}", v));
+            }
+            fmt::format_to(std::back_inserter(out), "{}\n", join(text, ","));
+        };
+
+        std::vector<int64_t> ticket(fields);
+        for (auto& v : ticket) {
+            v = free_value();
+        }
+
+        out.append(std::string_view{"\nyour ticket:\n"});
+        ticket_line(ticket);
+        out.append(std::string_view{"\nnearby tickets:\n"});
+
+        for (int64_t nearby = 0; nearby < scale; ++nearby) {
+            for (int64_t rank = 0; rank < fields; ++rank) {
+                auto column = static_cast<std::size_t>(column_of_rank[static_cast<std::size_t>(rank)]);
+
+                if (nearby < rank) ticket[column] = band_value(nearby);
+                else if (rank > 0 && rng.chance(0.5))
+                    ticket[column] = band_value(rng.between(0, rank - 1));
+                else
+                    ticket[column] = free_value();
+            }
+
+            if (nearby >= fields && rng.chance(0.2)) {
+                auto invalid = rng.chance(0.5) ? rng.between(0, 24) : rng.between(975, 999);
+                ticket[rng.index(ticket.size())] = invalid;
+            }
+
+            ticket_line(ticket);
+        }
+    }
+
+    // Square initial slice of the pocket dimension.
+    void generate_day17(buffer& out, int64_t scale, uint64_t seed)
+    {
+        random_source rng{seed};
+
+        for (int64_t row = 0; row < scale; ++row) {
+            for (int64_t column = 0; column < scale; ++column) {
+                out.push_back(rng.chance(0.45) ? '#' : '.');
+            }
+            out.push_back('\n');
+        }
+    }
+
+    // Appends an expression of two to five terms nested at most two deep and returns an upper bound
+    // on its value under either precedence rule (a + b <= a * b once both are at least 2).
+    double append_expression(std::string& line, random_source& rng, int depth)
+    {
+        double bound = 1;
+
+        for (auto terms = rng.between(2, 5), term = int64_t{0}; term < terms; ++term) {
+            if (term > 0) line += rng.chance(0.5) ? " + " : " * ";
+
+            if (depth < 2 && rng.chance(0.2)) {
+                line += '(';
+                bound *= std::max(2.0, append_expression(line, rng, depth + 1));
+                line += ')';
+            }
+            else {
+                auto digit = rng.between(1, 9);
+                line += static_cast<char>('0' + digit);
+                bound *= std::max<double>(2, static_cast<double>(digit));
+            }
+        }
+
+        return bound;
+    }
+
+    // Homework lines; any line whose value could push the final sum past int64_t is redrawn.
+    void generate_day18(buffer& out, int64_t scale, uint64_t seed)
+    {
+        random_source rng{seed};
+
+        auto limit = std::min(1e15, 9e18 / static_cast<double>(scale));
+
+        for (int64_t line = 0; line < scale; ++line) {
+            std::string expression;
+
+            do {
+                expression.clear();
+            } while (append_expression(expression, rng, 0) > limit);
+
+            fmt::format_to(std::back_inserter(out), "{}\n", expression);
+        }
+    }
+
+    // Message rules shaped like the puzzle's: 0: 8 11, 8: 42, 11: 42 31, where 42 matches the 8
+    // letter words with an even number of b's and 31 the odd ones. Messages are 42^n 31^m words
+    // (valid for part 2 when n > m >= 1) mixed with noise.
+    void generate_day19(buffer& out, int64_t scale, uint64_t seed)
+    {
+        random_source rng{seed};
+
+        constexpr int word_length = 8;
+
+        // even[j] / odd[j]: words of length j + 1 with an even / odd number of b's.
+        std::vector<int64_t> ids;
+        for (int64_t id = 1; id < 140; ++id) {
+            if (id != 8 && id != 11 && id != 31 && id != 42) ids.push_back(id);
+        }
+        rng.shuffle(ids);
+
+        std::vector<int64_t> even(word_length);
+        std::vector<int64_t> odd(word_length);
+        for (int j = 0; j + 1 < word_length; ++j) {
+            even[static_cast<std::size_t>(j)] = ids[static_cast<std::size_t>(2 * j)];
+            odd[static_cast<std::size_t>(j)]  = ids[static_cast<std::size_t>(2 * j + 1)];
+        }
+        even.back() = 42;
+        odd.back()  = 31;
+
+        std::vector<std::string> rules{"0: 8 11", "8: 42", "11: 42 31"};
+        rules.push_back(fmt::format("{}: \"a\"", even[0]));
+        rules.push_back(fmt::format("{}: \"b\"", odd[0]));
+
+        for (std::size_t j = 1; j < even.size(); ++j) {
+            auto a = even[0];
+            auto b = odd[0];
+            rules.push_back(fmt::format("{}: {} {} | {} {}", even[j], a, even[j - 1], b, odd[j - 1]));
+            rules.push_back(fmt::format("{}: {} {} | {} {}", odd[j], a, odd[j - 1], b, even[j - 1]));
+        }
+
+        rng.shuffle(rules);
+
+        for (const auto& rule : rules) {
+            fmt::format_to(std::back_inserter(out), "{}\n", rule);
+        }
+        out.push_back('\n');
+
+        auto word = [&rng](bool odd_bs) {
+            std::string w;
+            bool        parity = false;
+
+            for (int i = 0; i + 1 < word_length; ++i) {
+                bool b = rng.chance(0.5);
+                parity ^= b;
+                w += b ? 'b' : 'a';
+            }
+
+            w += parity != odd_bs ? 'b' : 'a';
+            return w;
+        };
+
+        for (int64_t message = 0; message < scale; ++message) {
+            std::string text;
+            auto        kind = rng.between(0, 9);
+
+            if (kind < 3) {
+                for (auto letters = word_length * rng.between(2, 8); letters > 0; --letters) {
+                    text += rng.chance(0.5) ? 'a' : 'b';
+                }
+            }
+            else {
+                auto leading  = kind < 5 ? 2 : rng.between(2, 6);
+                // kind 9 may repeat 31 as often as 42, which part 2 rejects.
+                auto most     = std::max<int64_t>(1, kind == 9 ? leading : leading - 1);
+                auto trailing = kind < 5 ? 1 : rng.between(1, most);
+
+                for (int64_t i = 0; i < leading; ++i) {
+                    text += word(false);
+                }
+                for (int64_t i = 0; i < trailing; ++i) {
+                    text += word(true);
+                }
+            }
+
+            fmt::format_to(std::back_inserter(out), "{}\n", text);
+        }
+    }
+
+    // Camera tiles for a scale x scale image. Each shared edge carries its own bit pattern that
+    // matches no other edge even when reversed, so tiles grow past the puzzle's 10x10 as the image
+    // needs more distinct edges. Sea monsters are drawn into the interior before the tiles are cut,
+    // rotated and flipped. Tile ids stay below 50000 so the product of the corners fits int64_t.
+    void generate_day20(buffer& out, int64_t scale, uint64_t seed)
+    {
+        random_source rng{seed};
+
+        auto width = static_cast<std::size_t>(scale);
+        auto edges = static_cast<int64_t>(2 * width * (width + 1));
+
+        int bits = 8;
+        while (((int64_t{1} << bits) - (int64_t{1} << ((bits + 1) / 2))) / 2 < edges) {
+            ++bits;
+        }
+
+        auto side  = static_cast<std::size_t>(bits) + 2;
+        auto inner = side - 2;
+
+        auto reversed = [bits](uint64_t x) {
+            uint64_t r = 0;
+            for (int i = 0; i < bits; ++i) {
+                r |= ((x >> i) & 1) << (bits - 1 - i);
+            }
+            return r;
+        };
+
+        std::vector<uint64_t> codes;
+        for (uint64_t x = 0; std::ssize(codes) < edges; ++x) {
+            if (x < reversed(x)) codes.push_back(x);
+        }
+        rng.shuffle(codes);
+
+        std::vector<char> corners((width + 1) * (width + 1));
+        for (auto& c : corners) {
+            c = rng.chance(0.5) ? '#' : '.';
+        }
+
+        std::size_t next_code = 0;
+
+        auto edge = [&](char first, char last) {
+            std::string e(side, '.');
+            auto        code = codes[next_code++];
+
+            e.front() = first;
+            e.back()  = last;
+            for (int i = 0; i < bits; ++i) {
+                if ((code >> i) & 1) e[static_cast<std::size_t>(i) + 1] = '#';
+            }
+            return e;
+        };
+
+        auto corner = [&corners, width](std::size_t row, std::size_t column) {
+            return corners[row * (width + 1) + column];
+        };
+
+        // horizontal[r * width + c] runs along the top of tile row r, vertical[r * (width + 1) + c]
+        // down the left of tile column c.
+        std::vector<std::string> horizontal;
+        for (std::size_t r = 0; r <= width; ++r) {
+            for (std::size_t c = 0; c < width; ++c) {
+                horizontal.push_back(edge(corner(r, c), corner(r, c + 1)));
+            }
+        }
+
+        std::vector<std::string> vertical;
+        for (std::size_t r = 0; r < width; ++r) {
+            for (std::size_t c = 0; c <= width; ++c) {
+                vertical.push_back(edge(corner(r, c), corner(r + 1, c)));
+            }
+        }
+
+        std::vector<std::string> image(width * inner, std::string(width * inner, '.'));
+        for (auto& row : image) {
+            for (auto& c : row) {
+                if (rng.chance(0.3)) c = '#';
+            }
+        }
+
+        constexpr std::array<std::string_view, 3> monster{
+            "                  # ",
+            "#    ##    ##    ###",
+            " #  #  #  #  #  #   "};
+
+        if (image.size() >= monster[0].size()) {
+            for (auto monsters = std::max<std::size_t>(1, width * width / 5); monsters > 0; --monsters) {
+                auto top  = rng.index(image.size() - monster.size() + 1);
+                auto left = rng.index(image.size() - monster[0].size() + 1);
+
+                for (std::size_t r = 0; r < monster.size(); ++r) {
+                    for (std::size_t c = 0; c < monster[r].size(); ++c) {
+                        if (monster[r][c] == '#') image[top + r][left + c] = '#';
+                    }
+                }
+            }
+        }
+
+        std::vector<int64_t> ids;
+        for (int64_t id = 1000; id < 50000; ++id) {
+            ids.push_back(id);
+        }
+        rng.shuffle(ids);
+
+        std::vector<std::pair<int64_t, std::vector<std::string>>> tiles;
+
+        for (std::size_t r = 0; r < width; ++r) {
+            for (std::size_t c = 0; c < width; ++c) {
+                std::vector<std::string> rows(side, std::string(side, '.'));
+
+                rows.front() = horizontal[r * width + c];
+                rows.back()  = horizontal[(r + 1) * width + c];
+
+                for (std::size_t i = 0; i < side; ++i) {
+                    rows[i].front() = vertical[r * (width + 1) + c][i];
+                    rows[i].back()  = vertical[r * (width + 1) + c + 1][i];
+                }
+
+                for (std::size_t i = 1; i + 1 < side; ++i) {
+                    for (std::size_t j = 1; j + 1 < side; ++j) {
+                        rows[i][j] = image[r * inner + i - 1][c * inner + j - 1];
+                    }
+                }
+
+                for (auto turns = rng.between(0, 3); turns > 0; --turns) {
+                    auto rotated = rows;
+                    for (std::size_t i = 0; i < side; ++i) {
+                        for (std::size_t j = 0; j < side; ++j) {
+                            rotated[i][j] = rows[side - 1 - j][i];
+                        }
+                    }
+                    rows = std::move(rotated);
+                }
+
+                if (rng.chance(0.5)) {
+                    for (auto& row : rows) {
+                        std::reverse(row.begin(), row.end());
+                    }
+                }
+
+                tiles.emplace_back(ids[tiles.size()], std::move(rows));
+            }
+        }
+
+        rng.shuffle(tiles);
+
+        for (std::size_t t = 0; t < tiles.size(); ++t) {
+            fmt::format_to(std::back_inserter(out), "{}Tile {}:\n", t == 0 ? "" : "\n", tiles[t].first);
+
+            for (const auto& row : tiles[t].second) {
+                fmt::format_to(std::back_inserter(out), "{}\n", row);
+            }
+        }
+    }
+
+    // Food list over a vocabulary that grows with scale. Each allergen has two anchor foods whose
+    // only common ingredient is the one carrying it, so its candidate set narrows to exactly that
+    // ingredient.
+    void generate_day21(buffer& out, int64_t scale, uint64_t seed)
+    {
+        random_source rng{seed};
+
+        constexpr std::array<std::string_view, 8> allergens{
+            "dairy", "eggs", "fish", "nuts", "peanuts", "sesame", "soy", "wheat"};
+
+        std::set<std::string> unique_words;
+        while (std::ssize(unique_words) < std::max<int64_t>(100, scale) + std::ssize(allergens)) {
+            std::string w;
+            for (auto length = rng.between(3, 8); length > 0; --length) {
+                w += rng.letter();
+            }
+            unique_words.insert(w);
+        }
+
+        std::vector<std::string> words{unique_words.begin(), unique_words.end()};
+        rng.shuffle(words);
+
+        std::vector<std::string> carriers{words.begin(), words.begin() + std::ssize(allergens)};
+        words.erase(words.begin(), words.begin() + std::ssize(allergens));
+
+        auto half = words.size() / 2;
+
+        auto safe_ingredients = [&](std::size_t first, std::size_t count) {
+            std::vector<std::string> picked;
+            for (auto n = rng.between(5, 20); n > 0; --n) {
+                picked.push_back(words[first + rng.index(count)]);
+            }
+            std::sort(picked.begin(), picked.end());
+            picked.erase(std::unique(picked.begin(), picked.end()), picked.end());
+            return picked;
+        };
+
+        std::vector<std::pair<std::vector<std::string>, std::vector<std::string>>> foods;
+
+        for (std::size_t a = 0; a < allergens.size(); ++a) {
+            for (std::size_t anchor = 0; anchor < 2; ++anchor) {
+                auto ingredients = safe_ingredients(anchor * half, half);
+                ingredients.push_back(carriers[a]);
+                foods.push_back({ingredients, {std::string{allergens[a]}}});
+            }
+        }
+
+        while (std::ssize(foods) < scale) {
+            auto ingredients = safe_ingredients(0, words.size());
+
+            std::vector<std::string> listed;
+
+            for (std::size_t a = 0; a < allergens.size(); ++a) {
+                if (rng.chance(0.3)) {
+                    ingredients.push_back(carriers[a]);
+                    if (rng.chance(0.6)) listed.emplace_back(allergens[a]);
+                }
+            }
+
+            if (listed.empty()) {
+                auto a = rng.index(allergens.size());
+                auto carrier = std::find(ingredients.begin(), ingredients.end(), carriers[a]);
+                if (carrier == ingredients.end()) ingredients.push_back(carriers[a]);
+                listed.emplace_back(allergens[a]);
+            }
+
+            std::sort(listed.begin(), listed.end());
+            foods.push_back({ingredients, listed});
+        }
+
+        rng.shuffle(foods);
+
+        for (auto& [ingredients, listed] : foods) {
+            rng.shuffle(ingredients);
+            fmt::format_to(
+                std::back_inserter(out),
+                "{} (contains {})\n",
+                join(ingredients, " "),
+                join(listed, ", "));
+        }
+    }
+
+    // Two decks of scale cards each, dealt from a shuffled 1..2 * scale.
+    void generate_day22(buffer& out, int64_t scale, uint64_t seed)
+    {
+        random_source rng{seed};
+
+        std::vector<int64_t> cards;
+        for (int64_t card = 1; card <= 2 * scale; ++card) {
+            cards.push_back(card);
+        }
+        rng.shuffle(cards);
+
+        for (int player = 0; player < 2; ++player) {
+            auto deck = std::span{cards}.subspan(static_cast<std::size_t>(player * scale));
+
+            if (player > 0) out.push_back('\n');
+            fmt::format_to(std::back_inserter(out), "Player {}:\n", player + 1);
+
+            for (auto card : deck.first(static_cast<std::size_t>(scale))) {
+                fmt::format_to(std::back_inserter(out), "{}\n", card);
+            }
+        }
+    }
+
+    // Cup labels are single digits, so only the order of 1-9 varies.
+    void generate_day23(buffer& out, int64_t, uint64_t seed)
+    {
+        random_source rng{seed};
+
+        std::string cups{"123456789"};
+        rng.shuffle(cups);
+
+        fmt::format_to(std::back_inserter(out), "{}\n", cups);
+    }
+
+    // Tile paths of 10 to 40 steps.
+    void generate_day24(buffer& out, int64_t scale, uint64_t seed)
+    {
+        random_source rng{seed};
+
+        constexpr std::array<std::string_view, 6> steps{"e", "se", "sw", "w", "nw", "ne"};
+
+        for (int64_t line = 0; line < scale; ++line) {
+            for (auto n = rng.between(10, 40); n > 0; --n) {
+                out.append(rng.pick(steps));
+            }
+            out.push_back('\n');
+        }
+    }
+
+    // Card and door public keys with loop sizes up to scale.
+    void generate_day25(buffer& out, int64_t scale, uint64_t seed)
+    {
+        random_source rng{seed};
+
+        auto public_key = [](int64_t loop_size) {
+            int64_t value = 1;
+            for (int64_t i = 0; i < loop_size; ++i) {
+                value = value * 7 % 20201227;
+            }
+            return value;
+        };
+
+        auto card = public_key(rng.between(1, scale));
+        auto door = public_key(rng.between(1, scale));
+
+        fmt::format_to(std::back_inserter(out), "{}\n{}\n", card, door);
+    }
+
+    constexpr int64_t unbounded = 1000000000;
+
+    constexpr std::array<input_generator, 25> generators{{
+        {1, "expense entries", 5, unbounded, 200, generate_day01},
+        {2, "password lines", 1, unbounded, 1000, generate_day02},
+        {3, "map rows", 1, unbounded, 323, generate_day03},
+        {4, "passports", 1, unbounded, 290, generate_day04},
+        {5, "boarding passes", 3, 1000, 800, generate_day05},
+        {6, "groups", 1, unbounded, 480, generate_day06},
+        {7, "bag colors", 16, unbounded, 594, generate_day07},
+        {8, "instructions", 4, unbounded, 650, generate_day08},
+        {9, "numbers", 30, unbounded, 1000, generate_day09},
+        {10, "adapters", 1, unbounded, 100, generate_day10},
+        {11, "seat map side", 1, unbounded, 95, generate_day11},
+        {12, "instructions", 1, unbounded, 780, generate_day12},
+        {13, "schedule slots", 10, unbounded, 61, generate_day13},
+        {14, "program lines", 1, unbounded, 580, generate_day14},
+        {15, "starting numbers", 1, 2019, 6, generate_day15},
+        {16, "nearby tickets", 20, unbounded, 240, generate_day16},
+        {17, "initial slice side", 1, 1000, 8, generate_day17},
+        {18, "expressions", 1, unbounded, 370, generate_day18},
+        {19, "messages", 1, unbounded, 430, generate_day19},
+        {20, "image side in tiles", 2, 200, 12, generate_day20},
+        {21, "foods", 16, unbounded, 40, generate_day21},
+        {22, "cards per player", 2, unbounded, 25, generate_day22},
+        {23, "cups (always 9)", 9, 9, 9, generate_day23},
+        {24, "tile paths", 1, unbounded, 330, generate_day24},
+        {25, "maximum loop size", 1, 20201226, 10000000, generate_day25},
+    }};
+
+} // namespace
+
+std::span<const input_generator> input_generators()
+{
+    return generators;
+}
+
+const input_generator* find_generator(int day)
+{
+    auto iter = std::find_if(generators.begin(), generators.end(), [day](const auto& g) {
+        return g.day == day;
+    });
+
+    return iter != generators.end() ? &*iter : nullptr;
+}
+
+} // namespace aoc
@@ -0,0 +1,175 @@
+#include <aoc2020/aoc2020.hpp>
+#include <aoc2020/alloc_tracker.hpp>
+#include <aoc2020/registry.hpp>
+#include <aoc2020/thread_pool.hpp>
+
+#include <fmt/core.h>
+
+#include <cstdio>
+#include <exception>
+#include <future>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace {
+
+// Every task hands its allocation totals back through its future, so no task refers to memory
+// owned by main(). allocs is filled in by main() as the answers are collected: the parse step
+// followed by each part.
+struct parse_result {
+    aoc::parsed_input input;
+    aoc::alloc::stats allocs;
+};
+
+struct part_result {
+    std::string       answer;
+    aoc::alloc::stats allocs;
+};
+
+struct day_run {
+    const aoc::day_solution*              solution;
+    std::shared_future<parse_result>      parsed;
+    std::vector<std::future<part_result>> answers;
+    std::vector<aoc::alloc::stats>        allocs;
+};
+
+// Every parse is queued ahead of every part, so a part blocking on its day's input only ever waits
+// for a parse that a worker has already picked up.
+std::vector<day_run> schedule(aoc::thread_pool& pool, const std::vector<const aoc::day_solution*>& days)
+{
+    std::vector<day_run> runs;
+    runs.reserve(days.size());
+
+    for (const auto* solution : days) {
+        auto& run = runs.emplace_back();
+
+        run.solution = solution;
+        run.parsed   = pool.submit([solution] {
+                         aoc::alloc::scope scope;
+                         auto input = solution->parse(aoc::default_input_path(solution->day));
+                         return parse_result{std::move(input), scope.totals()};
+                     }).share();
+    }
+
+    for (auto& run : runs) {
+        for (const auto& part_fn : run.solution->parts) {
+            run.answers.push_back(pool.submit([&part_fn, parsed = run.parsed] {
+                const auto& input = parsed.get().input;
+
+                aoc::alloc::scope scope;
+                auto answer = part_fn(input);
+                return part_result{std::move(answer), scope.totals()};
+            }));
+        }
+    }
+
+    return runs;
+}
+
+void print_allocations(const std::vector<day_run>& runs)
+{
+    fmt::print(
+        stderr,
+        "\n{:<16} {:>12} {:>16} {:>16}\n",
+        "phase",
+        "allocations",
+        "bytes",
+        "peak live bytes");
+
+    for (const auto& run : runs) {
+        for (std::size_t i = 0; i < run.allocs.size(); ++i) {
+            const auto& allocs = run.allocs[i];
+
+            fmt::print(
+                stderr,
+                "{:<16} {:>12} {:>16} {:>16}\n",
+                i == 0 ? fmt::format("day{:02}/parse", run.solution->day)
+                       : fmt::format("day{:02}/part{}", run.solution->day, i),
+                allocs.count,
+                allocs.bytes,
+                allocs.peak_live_bytes);
+        }
+    }
+}
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    try {
+        std::vector<int> days;
+        std::size_t      jobs = std::thread::hardware_concurrency();
+
+        for (int i = 1; i < argc; ++i) {
+            std::string_view arg{argv[i]};
+
+            if (arg == "--days" && i + 1 < argc) { days = aoc::parse_list<int>(argv[++i]); }
+            else if (arg.starts_with("--days=")) {
+                days = aoc::parse_list<int>(arg.substr(7));
+            }
+            else if (arg == "--jobs" && i + 1 < argc) {
+                jobs = static_cast<std::size_t>(std::stoi(argv[++i]));
+            }
+            else if (arg == "--trace" && i + 1 < argc) {
+                if (!aoc::trace::enabled) {
+                    fmt::print(stderr, "--trace needs a build with AOC2020_TRACE\n");
+                }
+                aoc::trace::write_timeline(argv[++i]);
+            }
+            else {
+                fmt::print(
+                    stderr,
+                    "usage: {} [--days N[,N...]] [--jobs N] [--trace FILE]\n",
+                    argv[0]);
+                return 1;
+            }
+        }
+
+        std::vector<const aoc::day_solution*> solutions;
+
+        if (days.empty()) {
+            for (const auto& solution : aoc::registered_days()) {
+                solutions.push_back(&solution);
+            }
+        }
+
+        for (int day : days) {
+            const auto* solution = aoc::find_day(day);
+
+            if (solution == nullptr) {
+                fmt::print(stderr, "Day {} is not part of this build\n", day);
+                return 1;
+            }
+
+            solutions.push_back(solution);
+        }
+
+        aoc::thread_pool pool{jobs};
+
+        auto runs = schedule(pool, solutions);
+
+        for (auto& run : runs) {
+            fmt::print("Advent of Code 2020 - Day {:02}\n", run.solution->day);
+
+            run.allocs.push_back(run.parsed.get().allocs);
+
+            for (std::size_t part = 0; part < run.answers.size(); ++part) {
+                auto result = run.answers[part].get();
+
+                fmt::print("Part {} Solution: {}\n", part + 1, result.answer);
+                run.allocs.push_back(result.allocs);
+            }
+        }
+
+        if (aoc::alloc::enabled()) print_allocations(runs);
+    }
+    catch (const std::exception& e) {
+        fmt::print(stderr, "{}\n", e.what());
+        return 1;
+    }
+
+    return 0;
+}
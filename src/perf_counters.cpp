@@ -0,0 +1,131 @@
+#include "perf_counters.hpp"
+
+#include <algorithm>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace aoc {
+
+#ifdef __linux__
+
+namespace {
+
+    struct counter_config {
+        uint32_t type;
+        uint64_t config;
+    };
+
+    constexpr uint64_t cache_miss(uint64_t cache)
+    {
+        return cache | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+    }
+
+    // Same order as perf_counter_names.
+    constexpr std::array<counter_config, perf_counter_names.size()> configs{{
+        {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES},
+        {PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS},
+        {PERF_TYPE_HW_CACHE, cache_miss(PERF_COUNT_HW_CACHE_L1D)},
+        {PERF_TYPE_HW_CACHE, cache_miss(PERF_COUNT_HW_CACHE_LL)},
+        {PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES},
+    }};
+
+    // The first counter that opens leads the group; the rest join it so they are scheduled on the
+    // PMU together and read in one call. A counter that would not fit the group fails to open.
+    int open_counter(const counter_config& counter, int group_fd)
+    {
+        perf_event_attr attr{};
+        attr.size           = sizeof(attr);
+        attr.type           = counter.type;
+        attr.config         = counter.config;
+        attr.disabled       = group_fd < 0 ? 1 : 0;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv     = 1;
+        attr.read_format
+            = PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+        return static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, group_fd, 0));
+    }
+
+} // namespace
+
+perf_counters::perf_counters()
+{
+    for (std::size_t i = 0; i < configs.size(); ++i) {
+        fds_[i] = open_counter(configs[i], leader_);
+        if (leader_ < 0) leader_ = fds_[i];
+    }
+}
+
+perf_counters::~perf_counters()
+{
+    // Members first, the leader last.
+    for (auto fd = fds_.rbegin(); fd != fds_.rend(); ++fd) {
+        if (*fd >= 0) close(*fd);
+    }
+}
+
+void perf_counters::start() noexcept
+{
+    if (leader_ < 0) return;
+
+    ioctl(leader_, PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+    ioctl(leader_, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+}
+
+// The group is read as {nr, time_enabled, time_running, value...} with one value per open counter
+// in the order they joined. A multiplexed group is scaled up to the full time it was enabled.
+perf_sample perf_counters::stop() noexcept
+{
+    perf_sample sample;
+
+    if (leader_ < 0) return sample;
+
+    ioctl(leader_, PERF_EVENT_IOC_DISABLE, PERF_IOC_FLAG_GROUP);
+
+    std::array<uint64_t, 3 + perf_counter_names.size()> reading{};
+
+    auto bytes = read(leader_, reading.data(), sizeof(reading));
+
+    if (bytes < static_cast<ssize_t>(3 * sizeof(uint64_t)) || reading[2] == 0) return sample;
+
+    auto scale = static_cast<double>(reading[1]) / static_cast<double>(reading[2]);
+    auto value = reading.begin() + 3;
+
+    for (std::size_t i = 0; i < fds_.size(); ++i) {
+        if (fds_[i] < 0) continue;
+
+        sample[i] = static_cast<int64_t>(static_cast<double>(*value++) * scale);
+    }
+
+    return sample;
+}
+
+#else
+
+perf_counters::perf_counters()
+{
+    fds_.fill(-1);
+}
+
+perf_counters::~perf_counters() = default;
+
+void perf_counters::start() noexcept {}
+
+perf_sample perf_counters::stop() noexcept
+{
+    return {};
+}
+
+#endif
+
+bool perf_counters::available() const noexcept
+{
+    return std::any_of(fds_.begin(), fds_.end(), [](int fd) { return fd >= 0; });
+}
+
+} // namespace aoc
@@ -0,0 +1,49 @@
+#include "registry.hpp"
+
+#include <fmt/format.h>
+
+#include <algorithm>
+
+namespace aoc {
+
+namespace {
+
+    std::vector<day_solution>& registry()
+    {
+        static std::vector<day_solution> days;
+        return days;
+    }
+
+} // namespace
+
+void register_day(day_solution solution)
+{
+    auto& days = registry();
+
+    auto pos = std::upper_bound(days.begin(), days.end(), solution.day, [](int day, const auto& s) {
+        return day < s.day;
+    });
+
+    days.insert(pos, std::move(solution));
+}
+
+const std::vector<day_solution>& registered_days()
+{
+    return registry();
+}
+
+const day_solution* find_day(int day)
+{
+    const auto& days = registry();
+
+    auto iter = std::find_if(days.begin(), days.end(), [day](const auto& s) { return s.day == day; });
+
+    return iter != days.end() ? &*iter : nullptr;
+}
+
+std::filesystem::path default_input_path(int day)
+{
+    return fmt::format("days/day{:02}/puzzle.in", day);
+}
+
+} // namespace aoc
@@ -0,0 +1,66 @@
+#include "thread_pool.hpp"
+
+#include <algorithm>
+
+namespace aoc {
+
+thread_pool::thread_pool(std::size_t threads)
+{
+    threads = std::max<std::size_t>(threads, 1);
+
+    workers_.reserve(threads);
+    for (std::size_t i = 0; i < threads; ++i) {
+        workers_.emplace_back([this] { work(); });
+    }
+}
+
+thread_pool::~thread_pool()
+{
+    {
+        std::lock_guard lock{mutex_};
+        stopping_ = true;
+    }
+
+    ready_.notify_all();
+
+    for (auto& worker : workers_) {
+        worker.join();
+    }
+}
+
+void thread_pool::enqueue(std::function<void()> task)
+{
+    {
+        std::lock_guard lock{mutex_};
+        tasks_.push_back(std::move(task));
+    }
+
+    ready_.notify_one();
+}
+
+void thread_pool::work()
+{
+    for (;;) {
+        std::function<void()> task;
+
+        {
+            std::unique_lock lock{mutex_};
+            ready_.wait(lock, [this] { return stopping_ || !tasks_.empty(); });
+
+            if (tasks_.empty()) return;
+
+            task = std::move(tasks_.front());
+            tasks_.pop_front();
+        }
+
+        task();
+    }
+}
+
+thread_pool& shared_pool()
+{
+    static thread_pool pool;
+    return pool;
+}
+
+} // namespace aoc
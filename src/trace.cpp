@@ -0,0 +1,294 @@
+#include "trace.hpp"
+
+#ifdef AOC2020_TRACE
+
+#include "aoc2020.hpp"
+
+#include <fmt/core.h>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <exception>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace aoc::trace {
+
+namespace {
+
+    constexpr std::size_t max_entries = 512;
+
+    struct phase_slot {
+        std::atomic<int64_t> calls{0};
+        std::atomic<int64_t> total_ns{0};
+        std::atomic<int64_t> min_ns{std::numeric_limits<int64_t>::max()};
+        std::atomic<int64_t> max_ns{0};
+    };
+
+    struct event {
+        std::size_t id;
+        int64_t     start_ns;
+        int64_t     stop_ns;
+    };
+
+    // Only ever appended to by the thread that owns it.
+    struct thread_events {
+        std::size_t        tid;
+        std::vector<event> events;
+    };
+
+    // Slots never move and names are written before their id is handed out, so the hot path only
+    // touches atomics and its own thread's event buffer. The mutex guards registration, the thread
+    // list and the exit report.
+    struct trace_state {
+        std::mutex                                    mutex;
+        std::array<std::string, max_entries>          phase_names;
+        std::array<phase_slot, max_entries>           phases;
+        std::size_t                                   phase_count = 0;
+        std::array<std::string, max_entries>          counter_names;
+        std::array<std::atomic<int64_t>, max_entries> counters{};
+        std::size_t                                   counter_count = 0;
+        std::atomic<bool>                             timeline_enabled{false};
+        std::atomic<int64_t>                          dropped_events{0};
+        std::string                                   timeline_path;
+        std::vector<std::unique_ptr<thread_events>>   threads;
+    };
+
+    // Never destroyed, so scopes closing during static destruction and the atexit report are safe.
+    trace_state& state()
+    {
+        static auto* s = new trace_state{};
+        return *s;
+    }
+
+    thread_events& local_events()
+    {
+        thread_local thread_events* events = [] {
+            auto& s = state();
+
+            std::lock_guard lock{s.mutex};
+            auto tid = s.threads.size() + 1;
+            s.threads.push_back(std::make_unique<thread_events>(thread_events{tid, {}}));
+            return s.threads.back().get();
+        }();
+
+        return *events;
+    }
+
+    // Chrome trace_event format: one complete ("X") event per closed scope, timestamps in
+    // microseconds relative to the earliest event.
+    void write_timeline_file(const trace_state& s)
+    {
+        std::FILE* out = std::fopen(s.timeline_path.c_str(), "w");
+
+        if (out == nullptr) {
+            fmt::print(stderr, "Unable to write trace timeline to {}\n", s.timeline_path);
+            return;
+        }
+
+        int64_t epoch = std::numeric_limits<int64_t>::max();
+        for (const auto& thread : s.threads) {
+            for (const auto& e : thread->events) {
+                epoch = std::min(epoch, e.start_ns);
+            }
+        }
+
+        fmt::print(out, "{{\"displayTimeUnit\": \"ms\", \"traceEvents\": [\n");
+
+        const char* separator = "";
+
+        for (const auto& thread : s.threads) {
+            fmt::print(
+                out,
+                R"({}{{"name": "thread_name", "ph": "M", "pid": 1, "tid": {}, )"
+                R"("args": {{"name": "thread {}"}}}})",
+                separator,
+                thread->tid,
+                thread->tid);
+            separator = ",\n";
+
+            for (const auto& e : thread->events) {
+                fmt::print(
+                    out,
+                    R"({}{{"name": "{}", "cat": "aoc", "ph": "X", "pid": 1, "tid": {}, )"
+                    R"("ts": {:.3f}, "dur": {:.3f}}})",
+                    separator,
+                    json_escape(s.phase_names[e.id]),
+                    thread->tid,
+                    static_cast<double>(e.start_ns - epoch) / 1e3,
+                    static_cast<double>(e.stop_ns - e.start_ns) / 1e3);
+            }
+        }
+
+        fmt::print(out, "\n]}}\n");
+        std::fclose(out);
+
+        if (auto dropped = s.dropped_events.load(); dropped != 0) {
+            fmt::print(stderr, "Trace timeline is missing {} events it had no room for\n", dropped);
+        }
+    }
+
+    void report_at_exit()
+    {
+        auto& s = state();
+
+        std::lock_guard lock{s.mutex};
+
+        if (s.timeline_enabled) write_timeline_file(s);
+
+        // Every day registers its phases up front, so only the ones that ran are reported.
+        std::vector<std::size_t> order;
+        for (std::size_t i = 0; i < s.phase_count; ++i) {
+            if (s.phases[i].calls.load() != 0) order.push_back(i);
+        }
+        std::sort(order.begin(), order.end(), [&s](auto a, auto b) {
+            return s.phase_names[a] < s.phase_names[b];
+        });
+
+        if (!order.empty()) {
+            fmt::print(
+                stderr,
+                "\n{:<40} {:>10} {:>12} {:>12} {:>12} {:>12}\n",
+                "phase",
+                "calls",
+                "total ms",
+                "mean us",
+                "min us",
+                "max us");
+        }
+
+        for (auto i : order) {
+            const auto& slot  = s.phases[i];
+            auto        calls = slot.calls.load();
+            auto        total = slot.total_ns.load();
+
+            fmt::print(
+                stderr,
+                "{:<40} {:>10} {:>12.3f} {:>12.3f} {:>12.3f} {:>12.3f}\n",
+                s.phase_names[i],
+                calls,
+                static_cast<double>(total) / 1e6,
+                static_cast<double>(total) / static_cast<double>(calls) / 1e3,
+                static_cast<double>(slot.min_ns.load()) / 1e3,
+                static_cast<double>(slot.max_ns.load()) / 1e3);
+        }
+
+        if (s.counter_count == 0) return;
+
+        fmt::print(stderr, "\n{:<40} {:>10}\n", "counter", "value");
+
+        for (std::size_t i = 0; i < s.counter_count; ++i) {
+            fmt::print(stderr, "{:<40} {:>10}\n", s.counter_names[i], s.counters[i].load());
+        }
+    }
+
+    void report_on_exit()
+    {
+        static std::once_flag report_registered;
+        std::call_once(report_registered, [] { std::atexit(report_at_exit); });
+    }
+
+    std::size_t register_name(
+        std::array<std::string, max_entries>& names,
+        std::size_t&                          count,
+        std::string_view                      name)
+    {
+        report_on_exit();
+
+        auto last = names.begin() + static_cast<std::ptrdiff_t>(count);
+        auto iter = std::find(names.begin(), last, name);
+
+        if (iter != last) return static_cast<std::size_t>(iter - names.begin());
+
+        if (count == max_entries) throw std::length_error{"too many aoc::trace entries"};
+
+        names[count] = name;
+        return count++;
+    }
+
+    void update_min(std::atomic<int64_t>& target, int64_t value) noexcept
+    {
+        auto current = target.load(std::memory_order_relaxed);
+        while (value < current
+               && !target.compare_exchange_weak(current, value, std::memory_order_relaxed)) {}
+    }
+
+    void update_max(std::atomic<int64_t>& target, int64_t value) noexcept
+    {
+        auto current = target.load(std::memory_order_relaxed);
+        while (value > current
+               && !target.compare_exchange_weak(current, value, std::memory_order_relaxed)) {}
+    }
+
+} // namespace
+
+namespace detail {
+
+    std::size_t register_phase(std::string_view name)
+    {
+        auto& s = state();
+
+        std::lock_guard lock{s.mutex};
+        return register_name(s.phase_names, s.phase_count, name);
+    }
+
+    std::size_t register_counter(std::string_view name)
+    {
+        auto& s = state();
+
+        std::lock_guard lock{s.mutex};
+        return register_name(s.counter_names, s.counter_count, name);
+    }
+
+    void record_phase(std::size_t id, int64_t start_ns, int64_t stop_ns) noexcept
+    {
+        auto& s          = state();
+        auto& slot       = s.phases[id];
+        auto  elapsed_ns = stop_ns - start_ns;
+
+        // Scopes close in destructors, so an event the timeline has no room for is dropped and
+        // counted instead of escaping.
+        if (s.timeline_enabled.load(std::memory_order_relaxed)) {
+            try {
+                local_events().events.push_back({id, start_ns, stop_ns});
+            }
+            catch (const std::exception&) {
+                s.dropped_events.fetch_add(1, std::memory_order_relaxed);
+            }
+        }
+
+        slot.calls.fetch_add(1, std::memory_order_relaxed);
+        slot.total_ns.fetch_add(elapsed_ns, std::memory_order_relaxed);
+        update_min(slot.min_ns, elapsed_ns);
+        update_max(slot.max_ns, elapsed_ns);
+    }
+
+    void add_counter(std::size_t id, int64_t amount) noexcept
+    {
+        state().counters[id].fetch_add(amount, std::memory_order_relaxed);
+    }
+
+} // namespace detail
+
+void write_timeline(const std::filesystem::path& path)
+{
+    report_on_exit();
+
+    auto& s = state();
+
+    std::lock_guard lock{s.mutex};
+    s.timeline_path = path.string();
+    s.timeline_enabled.store(true);
+}
+
+} // namespace aoc::trace
+
+#endif